@@ -0,0 +1,167 @@
+/**
+ * Microbenchmark of the fetched values decoding. It compares the switch on the host type for each
+ * value, which the statements used before, with the converters that are chosen once per result set.
+ * Synthetic rows of a wide result set are decoded into TCL lists, thus neither a MaxDB instance nor
+ * the SQLDBC library is needed, only the SQLDBC headers for the host type constants.
+ *
+ * ```
+ * make -f unix/Makefile bench
+ * ```
+ */
+#include "sdbtcl.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+struct BenchColumn;
+
+typedef Tcl_Obj* (*BenchDecoder) (const BenchColumn& col, void* data, SQLDBC_Length len);
+
+struct BenchColumn {
+    SQLDBC_HostType hostType;
+    SQLDBC_Length   length;   /// length indicator of the fetched value
+    size_t          offset;   /// where the value is in the row buffer
+    BenchDecoder    decode;
+};
+
+template <SQLDBC_HostType hostType>
+static Tcl_Obj* decodeValue (const BenchColumn& col, void* data, SQLDBC_Length len);
+
+template <>
+Tcl_Obj* decodeValue<SQLDBC_HOSTTYPE_INT4>(const BenchColumn& col, void* data, SQLDBC_Length len)
+{
+    return Tcl_NewIntObj(*(int*) data);
+}
+
+template <>
+Tcl_Obj* decodeValue<SQLDBC_HOSTTYPE_INT8>(const BenchColumn& col, void* data, SQLDBC_Length len)
+{
+    return Tcl_NewWideIntObj(*(Tcl_WideInt*) data);
+}
+
+template <>
+Tcl_Obj* decodeValue<SQLDBC_HOSTTYPE_DOUBLE>(const BenchColumn& col, void* data, SQLDBC_Length len)
+{
+    return Tcl_NewDoubleObj(*(double*) data);
+}
+
+template <>
+Tcl_Obj* decodeValue<SQLDBC_HOSTTYPE_BINARY>(const BenchColumn& col, void* data, SQLDBC_Length len)
+{
+    return Tcl_NewByteArrayObj((unsigned char*) data, len);
+}
+
+template <>
+Tcl_Obj* decodeValue<SQLDBC_HOSTTYPE_UTF8>(const BenchColumn& col, void* data, SQLDBC_Length len)
+{
+    return Tcl_NewStringObj((char*) data, len);
+}
+
+static BenchDecoder getValueDecoder (SQLDBC_HostType hostType)
+{
+    switch (hostType) {
+        case SQLDBC_HOSTTYPE_INT4:   return decodeValue<SQLDBC_HOSTTYPE_INT4>;
+        case SQLDBC_HOSTTYPE_INT8:   return decodeValue<SQLDBC_HOSTTYPE_INT8>;
+        case SQLDBC_HOSTTYPE_DOUBLE: return decodeValue<SQLDBC_HOSTTYPE_DOUBLE>;
+        case SQLDBC_HOSTTYPE_BINARY: return decodeValue<SQLDBC_HOSTTYPE_BINARY>;
+        default:                     return decodeValue<SQLDBC_HOSTTYPE_UTF8>;
+    }
+}
+
+/**
+ * Converts the value the way the statements did it before the converters were chosen per result set.
+ */
+static Tcl_Obj* decodeBySwitch (const BenchColumn& col, void* data, SQLDBC_Length len)
+{
+    switch (col.hostType) {
+        case SQLDBC_HOSTTYPE_INT4:   return Tcl_NewIntObj(*(int*) data);
+        case SQLDBC_HOSTTYPE_INT8:   return Tcl_NewWideIntObj(*(Tcl_WideInt*) data);
+        case SQLDBC_HOSTTYPE_DOUBLE: return Tcl_NewDoubleObj(*(double*) data);
+        case SQLDBC_HOSTTYPE_BINARY: return Tcl_NewByteArrayObj((unsigned char*) data, len);
+        default:                     return Tcl_NewStringObj((char*) data, len);
+    }
+}
+
+/**
+ * Builds 64 columns of mixed types and fills the row buffer with their values.
+ */
+static std::vector<BenchColumn> makeColumns (std::vector<char>& row)
+{
+    static const SQLDBC_HostType types[] = {
+        SQLDBC_HOSTTYPE_INT4, SQLDBC_HOSTTYPE_UTF8, SQLDBC_HOSTTYPE_DOUBLE, SQLDBC_HOSTTYPE_UTF8,
+        SQLDBC_HOSTTYPE_INT8, SQLDBC_HOSTTYPE_INT4, SQLDBC_HOSTTYPE_BINARY, SQLDBC_HOSTTYPE_UTF8,
+        SQLDBC_HOSTTYPE_DOUBLE, SQLDBC_HOSTTYPE_INT4, SQLDBC_HOSTTYPE_UTF8, SQLDBC_HOSTTYPE_INT8, SQLDBC_HOSTTYPE_DOUBLE
+    };
+    const int numTypes = sizeof(types) / sizeof(types[0]);
+
+    std::vector<BenchColumn> cols;
+    size_t                   rowSize = 0;
+    for (int i = 0; i < 64; i++) {
+        BenchColumn col;
+        col.hostType = types[(i * 7) % numTypes];
+        col.length   = col.hostType == SQLDBC_HOSTTYPE_UTF8 ? 8 + i % 24 : col.hostType == SQLDBC_HOSTTYPE_BINARY ? 8 : sizeof(Tcl_WideInt);
+        col.offset   = rowSize;
+        col.decode   = getValueDecoder(col.hostType);
+        rowSize += (col.length + 7) & ~(SQLDBC_Length) 7;
+        cols.push_back(col);
+    }
+    row.assign(rowSize, 'x');
+    for (auto it = cols.begin(); it != cols.end(); ++it) {
+        char* data = row.data() + it->offset;
+        switch (it->hostType) {
+            case SQLDBC_HOSTTYPE_INT4:   *(int*) data = (int) it->offset; break;
+            case SQLDBC_HOSTTYPE_INT8:   *(Tcl_WideInt*) data = (Tcl_WideInt) it->offset << 32; break;
+            case SQLDBC_HOSTTYPE_DOUBLE: *(double*) data = it->offset / 3.0; break;
+            default:                     break;
+        }
+    }
+    return cols;
+}
+
+/**
+ * Decodes the row into a list numRows times and returns the best time of several runs in nanoseconds per row.
+ */
+template <bool bySwitch>
+static double decodeRows (std::vector<BenchColumn>& cols, std::vector<char>& row, int numRows)
+{
+    std::vector<Tcl_Obj*> values(cols.size());
+    double                best = 0;
+    for (int run = 0; run < 5; run++) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < numRows; i++) {
+            for (size_t c = 0; c < cols.size(); c++) {
+                const BenchColumn& col  = cols[c];
+                void*              data = row.data() + col.offset;
+                values[c] = bySwitch ? decodeBySwitch(col, data, col.length) : col.decode(col, data, col.length);
+            }
+            Tcl_Obj* list = Tcl_NewListObj(values.size(), values.data());
+            Tcl_IncrRefCount(list);
+            Tcl_DecrRefCount(list);
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        double                                   perRow  = elapsed.count() / numRows;
+        best = (run == 0 ? perRow : std::min(best, perRow));
+    }
+    return best;
+}
+
+int main (int argc, char* argv[])
+{
+    Tcl_FindExecutable(argv[0]);
+
+    int numRows = (argc > 1 ? atoi(argv[1]) : 100000);
+
+    std::vector<char>        row;
+    std::vector<BenchColumn> cols = makeColumns(row);
+
+    decodeRows<true>(cols, row, numRows / 10);
+    double bySwitch    = decodeRows<true>(cols, row, numRows);
+    double byConverter = decodeRows<false>(cols, row, numRows);
+
+    std::printf("%d columns, %d rows\n", (int) cols.size(), numRows);
+    std::printf("switch per value:       %8.1f ns/row\n", bySwitch);
+    std::printf("converter per column:   %8.1f ns/row\n", byConverter);
+    return 0;
+}
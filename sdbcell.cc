@@ -0,0 +1,63 @@
+#include "sdbcell.h"
+#include <cstring>
+
+/**
+ * Fetched, but not yet converted, packed decimal. The packed digits follow the header in the same allocation.
+ */
+struct SdbCell {
+    SQLDBC_Int2 precision;  /// number of digits in the packed decimal
+
+    unsigned char* data () { return (unsigned char*) (this + 1); }
+};
+
+static void freeIntRep (Tcl_Obj* obj)
+{
+    Tcl_Free((char*) obj->internalRep.otherValuePtr);
+    obj->internalRep.otherValuePtr = nullptr;
+}
+
+static void dupIntRep (Tcl_Obj* src, Tcl_Obj* dst)
+{
+    SdbCell* cell = (SdbCell*) src->internalRep.otherValuePtr;
+    size_t   size = sizeof(SdbCell) + decimalSize(cell->precision);
+
+    dst->internalRep.otherValuePtr = std::memcpy(Tcl_Alloc(size), cell, size);
+    dst->typePtr                   = &sdbCellType;
+}
+
+/**
+ * Generates string representation of the decimal directly from its packed digits, so the bignum
+ * is never built when only the text of the value is used. The internal representation is kept,
+ * and the numeric value is parsed from the digits by the TCL types when it is requested.
+ */
+static void updateStringRep (Tcl_Obj* obj)
+{
+    SdbCell* cell = (SdbCell*) obj->internalRep.otherValuePtr;
+
+    obj->bytes              = Tcl_Alloc(decimalSize(cell->precision) * 2 + 1);
+    obj->length             = formatDecimal(cell->data(), cell->precision, obj->bytes);
+    obj->bytes[obj->length] = '\0';
+}
+
+Tcl_ObjType sdbCellType = {
+    .name             = (char*) "sdbcell",
+    .freeIntRepProc   = freeIntRep,
+    .dupIntRepProc    = dupIntRep,
+    .updateStringProc = updateStringRep,
+};
+
+Tcl_Obj* Tcl_NewSdbCellObj (SQLDBC_Int2 precision, const unsigned char* data)
+{
+    // only the value is copied, the length indicator of packed decimals is not the size of their buffer
+    size_t   size = decimalSize(precision);
+    SdbCell* cell = (SdbCell*) Tcl_Alloc(sizeof(SdbCell) + size);
+
+    cell->precision = precision;
+    std::memcpy(cell->data(), data, size);
+
+    Tcl_Obj* obj = Tcl_NewObj();
+    Tcl_InvalidateStringRep(obj);
+    obj->typePtr                   = &sdbCellType;
+    obj->internalRep.otherValuePtr = cell;
+    return obj;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "sdbtcl.h"
+
+extern Tcl_ObjType sdbCellType;
+
+/**
+ * Creates new Tcl object for the fetched packed decimal that will be converted into its TCL
+ * representation only when that is requested. The object keeps a copy of the packed digits,
+ * so it does not depend on the buffer that the value was fetched into.
+ */
+Tcl_Obj* Tcl_NewSdbCellObj (SQLDBC_Int2 precision, const unsigned char* data);
@@ -1,37 +1,215 @@
 #include "sdbconn.h"
 #include "sdbstmt.h"
 #include "sdblob.h"
+#include "sdbsource.h"
 #include <cstring>
 
-SdbConn::SdbConn(SdbEnv& env) : env(env), conn(nullptr), stmt(nullptr), cmd(nullptr)
+void StmtCache::evict(Entries::iterator entry)
+{
+    SdbPrepStmt* stmt = entry->second;
+    index.erase(entry->first);
+    stamps.erase(stmt->getPrepareStamp());
+    entries.erase(entry);
+    // SQL text objects do not reference the statement, so unless it is used by statement
+    // handles this closes it in the database
+    stmt->setCached(false);
+    stmt->release();
+}
+
+void StmtCache::shrink(size_t size)
+{
+    while (entries.size() > size) {
+        evict(std::prev(entries.end()));
+    }
+}
+
+void StmtCache::setCapacity(size_t capacity)
+{
+    this->capacity = capacity;
+    shrink(capacity);
+}
+
+SdbPrepStmt* StmtCache::use(Entries::iterator entry)
+{
+    SdbPrepStmt* stmt = entry->second;
+    if (stmt->hasHandles() || stmt->hasOptions()) {
+        return nullptr;
+    }
+    entries.splice(entries.begin(), entries, entry);
+    return stmt;
+}
+
+SdbPrepStmt* StmtCache::get(const char* sql, int len)
+{
+    auto found = index.find(std::string_view(sql, len));
+    SdbPrepStmt* stmt = found != index.end() ? use(found->second) : nullptr;
+    if (stmt == nullptr) {
+        ++misses;
+        return nullptr;
+    }
+    ++hits;
+    return stmt;
+}
+
+SdbPrepStmt* StmtCache::find(unsigned long stamp)
+{
+    auto found = stamps.find(stamp);
+    return found != stamps.end() ? use(found->second) : nullptr;
+}
+
+void StmtCache::put(const char* sql, int len, SdbPrepStmt* stmt)
+{
+    if (capacity == 0) {
+        return;
+    }
+    auto found = index.find(std::string_view(sql, len));
+    if (found != index.end()) {
+        evict(found->second);
+    } else {
+        shrink(capacity - 1);
+    }
+    entries.emplace_front(std::string(sql, len), stmt);
+    index.emplace(entries.front().first, entries.begin());
+    stamps.emplace(stmt->getPrepareStamp(), entries.begin());
+    stmt->setCached(true);
+    stmt->preserve();
+}
+
+void StmtCache::clear()
+{
+    shrink(0);
+}
+
+SdbConn::SdbConn(SdbEnv& env) : env(env), conn(nullptr), stmt(nullptr), lastStmt(nullptr), cmd(nullptr), autoParam(false)
 {
     env.preserve();
 }
 
 SdbConn::~SdbConn()
 {
+    while (!readAheadLobs.empty()) {
+        (*readAheadLobs.begin())->stopReadAhead();
+    }
     for (auto it = statements.begin(); it != statements.end(); ++it) {
         SdbStmt* stmt = *it;
         stmt->releaseDatabaseHandles();
     }
-    if (stmt) stmt->releaseDatabaseHandles();
+    if (stmt) stmt->release();
+    setLastStmt(nullptr);
+    stmtCache.clear();
     env.releaseConnection(conn);
     env.release();
 }
 
+void SdbConn::pauseLobReads(SdbLob* except)
+{
+    for (auto it = readAheadLobs.begin(); it != readAheadLobs.end(); ++it) {
+        if (*it != except) {
+            (*it)->pauseReadAhead();
+        }
+    }
+}
+
+static void SdbConn_Free (char* sdbconn)
+{
+    delete (SdbConn*) sdbconn;
+}
+
+/**
+ * Deletes the connection when the database command is deleted. The deletion is
+ * postponed if the connection is still in use, for example, by `foreach`.
+ */
 static void SdbConn_Delete (SdbConn* sdbconn)
 {
-    delete sdbconn;
+    Tcl_EventuallyFree(sdbconn, SdbConn_Free);
 }
 
 SdbStmt* SdbConn::myStmt()
 {
     if (stmt == nullptr) {
         stmt = new SdbStmt(this);
+        // LOBs that were fetched by the statement might outlive the connection
+        stmt->preserve();
     }
     return stmt;
 }
 
+void SdbConn::setLastStmt(SdbStmt* stmt)
+{
+    if (stmt) stmt->preserve();
+    if (lastStmt) lastStmt->release();
+    lastStmt = stmt;
+}
+
+int SdbConn::prepareCached(Tcl_Interp* interp, Tcl_Obj* sqlObj, SdbPrepStmt** stmtPtr)
+{
+    // SQL literals remember stamps of their statements, so the SQL text does not need to be hashed
+    SdbPrepStmt*  stmt;
+    unsigned long stamp;
+    if (Tcl_GetSdbSqlStamp(sqlObj, &stamp) && (stmt = stmtCache.find(stamp)) != nullptr) {
+        ++stmtCache.hits;
+        *stmtPtr = stmt;
+        return TCL_OK;
+    }
+
+    int         sqlLen;
+    const char* sql = Tcl_GetStringFromObj(sqlObj, &sqlLen);
+
+    stmt = stmtCache.get(sql, sqlLen);
+    if (stmt == nullptr) {
+        auto newStmt = std::make_unique<SdbPrepStmt>(this);
+        if (newStmt->prepare(interp, sqlObj) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        stmt = newStmt.release();
+        stmtCache.put(sql, sqlLen, stmt);
+    }
+    if (stmt->isCached()) {
+        Tcl_SetSdbSqlStamp(sqlObj, stmt);
+    }
+    *stmtPtr = stmt;
+    return TCL_OK;
+}
+
+int SdbConn::executeLifted(Tcl_Interp* interp, Tcl_Obj* sqlObj, ResultSetConfig& config, bool* isLiftedPtr)
+{
+    *isLiftedPtr = false;
+
+    int         sqlLen;
+    const char* sql = Tcl_GetStringFromObj(sqlObj, &sqlLen);
+
+    std::string           text;
+    std::vector<Tcl_Obj*> args;
+    if (!liftSqlLiterals(sql, sqlLen, text, args)) {
+        return TCL_OK;
+    }
+
+    int rc = TCL_OK;
+    if (unliftable.find(text) == unliftable.end()) {
+        Tcl_Obj* textObj = Tcl_NewStringObj(text.data(), text.size());
+        Tcl_IncrRefCount(textObj);
+
+        SdbPrepStmt* prepStmt;
+        if (prepareCached(interp, textObj, &prepStmt) != TCL_OK) {
+            // literals are not accepted as parameters in this statement, so it will be executed as is
+            if (unliftable.size() >= SqlScanCache::MAX_SIZE) {
+                unliftable.clear();
+            }
+            unliftable.insert(text);
+            Tcl_ResetResult(interp);
+        } else {
+            *isLiftedPtr = true;
+            setLastStmt(prepStmt);
+            rc = prepStmt->execute(interp, 0, args.size(), args.data(), config);
+        }
+        Tcl_DecrRefCount(textObj);
+    }
+    for (auto it = args.begin(); it != args.end(); ++it) {
+        Tcl_DecrRefCount(*it);
+    }
+    return rc;
+}
+
 static const NamedValue ISOLATION_LEVELS[] = {
     {"READ UNCOMMITTED",                16, 0 },
     {"READ COMMITTED",                  14, 1 },
@@ -81,9 +259,9 @@ SQLDBC_PreparedStatement* SdbConn::createPreparedStatement()
     return conn->createPreparedStatement();
 }
 
-static const char* CONNECT_OPTIONS[] = {"-autocommit", "-database", "-host", "-isolationlevel", "-key", "-password", "-sqlmode", "-user", NULL};
+static const char* CONNECT_OPTIONS[] = {"-autocommit", "-autoparam", "-database", "-host", "-isolationlevel", "-key", "-password", "-sqlmode", "-stmtcache", "-user", NULL};
 
-enum ConnOption { AUTOCOMMIT, DATABASE, HOST, ISOLATIONLEVEL, KEY, PASSWORD, SQLMODE, USER };
+enum ConnOption { AUTOCOMMIT, AUTOPARAM, DATABASE, HOST, ISOLATIONLEVEL, KEY, PASSWORD, SQLMODE, STMTCACHE, USER };
 
 int SdbConn::connect(Tcl_Interp* interp, int argc, Tcl_Obj* const argv[])
 {
@@ -132,6 +310,14 @@ int SdbConn::connect(Tcl_Interp* interp, int argc, Tcl_Obj* const argv[])
                         return TCL_ERROR;
                     }
                     break;
+                case AUTOPARAM: {
+                    int isOn;
+                    if (Tcl_GetBooleanFromObj(interp, argv[i + 1], &isOn) != TCL_OK) {
+                        return TCL_ERROR;
+                    }
+                    autoParam = isOn;
+                    break;
+                }
                 case ISOLATIONLEVEL:
                     if (scanIsolationLevel(interp, argv[i + 1], &isolationLevel) != TCL_OK) {
                         return TCL_ERROR;
@@ -142,6 +328,18 @@ int SdbConn::connect(Tcl_Interp* interp, int argc, Tcl_Obj* const argv[])
                         return TCL_ERROR;
                     }
                     break;
+                case STMTCACHE: {
+                    int capacity;
+                    if (Tcl_GetIntFromObj(interp, argv[i + 1], &capacity) != TCL_OK) {
+                        return TCL_ERROR;
+                    }
+                    if (capacity < 0) {
+                        TclSetResult(interp, "statement cache size cannot be negative", TCL_STATIC);
+                        return TCL_ERROR;
+                    }
+                    stmtCache.setCapacity(capacity);
+                    break;
+                }
             }
         } else {
             int optNameLen;
@@ -159,6 +357,10 @@ int SdbConn::connect(Tcl_Interp* interp, int argc, Tcl_Obj* const argv[])
     }
 
     SQLDBC_Retcode rc;
+    if (autoParam && stmtCache.getCapacity() == 0) {
+        stmtCache.setCapacity(AUTOPARAM_CACHE_SIZE);
+    }
+
     if (keyProvided) {
         rc = conn->connect(props);
     } else {
@@ -329,8 +531,8 @@ int SdbConn::get(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
         return TCL_ERROR;
     }
 
-    static const char* properties[] = {"datetimeformat", "kernelversion", NULL};
-    enum { DATETIMEFORMAT, KERNELVERSION } index;
+    static const char* properties[] = {"datetimeformat", "kernelversion", "stmtcache", NULL};
+    enum { DATETIMEFORMAT, KERNELVERSION, STMTCACHE } index;
 
     if (Tcl_GetIndexFromObj(interp, objv[2], properties, "property", 0, (int*) &index) != TCL_OK) {
         return TCL_ERROR;
@@ -347,6 +549,19 @@ int SdbConn::get(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
             break;
         }
         case KERNELVERSION: Tcl_SetObjResult(interp, Tcl_NewIntObj(conn->getKernelVersion())); break;
+        case STMTCACHE: {
+            Tcl_Obj* items[8];
+            items[0] = TCL_STR(capacity);
+            items[1] = Tcl_NewWideIntObj(stmtCache.getCapacity());
+            items[2] = TCL_STR(size);
+            items[3] = Tcl_NewWideIntObj(stmtCache.size());
+            items[4] = TCL_STR(hits);
+            items[5] = Tcl_NewWideIntObj(stmtCache.hits);
+            items[6] = TCL_STR(misses);
+            items[7] = Tcl_NewWideIntObj(stmtCache.misses);
+            Tcl_SetObjResult(interp, Tcl_NewListObj(8, items));
+            break;
+        }
     }
     return TCL_OK;
 }
@@ -387,6 +602,16 @@ int SdbConn::prepare(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
         return TCL_ERROR;
     }
 
+    if (objc == 3 && stmtCache.getCapacity() > 0) {
+        // statements with options are not cached as options change their state
+        SdbPrepStmt* stmt;
+        if (prepareCached(interp, objv[2], &stmt) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        Tcl_SetObjResult(interp, Tcl_NewSdbStmtObj(stmt));
+        return TCL_OK;
+    }
+
     return SdbPrepStmt_New(this, interp, objc - 2, objv + 2);
 }
 
@@ -409,6 +634,134 @@ int SdbConn::batch(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
     return stmt->batch(interp, objc - i, objv + i);
 }
 
+int SdbConn::executeMany(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
+{
+    if (objc != 4 && objc != 6) {
+        // db executemany $stmt $rows
+        // db executemany -batch 500 $stmt $rows
+        Tcl_WrongNumArgs(interp, 2, objv, "?-batch size? stmt rows");
+        return TCL_ERROR;
+    }
+
+    static const char* options[] = {"-batch", NULL};
+
+    int batchSize = SdbStmt::DEFAULT_BATCH_SIZE;
+    int i         = 2;
+    if (objc == 6) {
+        int opt;
+        if (Tcl_GetIndexFromObj(interp, objv[i], options, "option", 0, &opt) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        if (Tcl_GetIntFromObj(interp, objv[i + 1], &batchSize) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        if (batchSize <= 0) {
+            TclSetResult(interp, "batch size must be positive", TCL_STATIC);
+            return TCL_ERROR;
+        }
+        i += 2;
+    }
+
+    SdbStmt* stmt;
+    if (Tcl_GetSdbStmtFromObj(objv[i], &stmt) != TCL_OK) {
+        const char* typeName = objv[i]->typePtr ? objv[i]->typePtr->name : "string";
+        Tcl_AppendResult(interp, "a statement handler is expected, but a ", typeName, " was given", nullptr);
+        return TCL_ERROR;
+    }
+
+    return stmt->executeMany(interp, objv[i + 1], batchSize);
+}
+
+int SdbConn::load(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
+{
+    if (objc < 5 || objc % 2 == 0) {
+        // db load $stmt -channel $chan
+        // db load $stmt -channel $chan -format tsv -nullas \\N -batch 5000
+        Tcl_WrongNumArgs(interp, 2, objv, "stmt -channel chan ?-format csv|tsv? ?-delimiter char? ?-nullas str? ?-batch size?");
+        return TCL_ERROR;
+    }
+
+    SdbStmt* stmt;
+    if (Tcl_GetSdbStmtFromObj(objv[2], &stmt) != TCL_OK) {
+        const char* typeName = objv[2]->typePtr ? objv[2]->typePtr->name : "string";
+        Tcl_AppendResult(interp, "a statement handler is expected, but a ", typeName, " was given", nullptr);
+        return TCL_ERROR;
+    }
+
+    static const char* options[] = {"-batch", "-channel", "-delimiter", "-format", "-nullas", NULL};
+    enum { BATCH, CHANNEL, DELIMITER, FORMAT, NULLAS } opt;
+
+    static const char* formats[] = {"csv", "tsv", NULL};
+    enum { CSV, TSV } format;
+
+    LoadFormat  loadFormat;
+    Tcl_Channel chan      = nullptr;
+    Tcl_Obj*    delimiter = nullptr;
+    int         batchSize = SdbStmt::DEFAULT_BATCH_SIZE;
+
+    for (int i = 3; i < objc; i += 2) {
+        if (Tcl_GetIndexFromObj(interp, objv[i], options, "option", 0, (int*) &opt) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        Tcl_Obj* val = objv[i + 1];
+        switch (opt) {
+            case BATCH: {
+                if (Tcl_GetIntFromObj(interp, val, &batchSize) != TCL_OK) {
+                    return TCL_ERROR;
+                }
+                if (batchSize <= 0) {
+                    TclSetResult(interp, "batch size must be positive", TCL_STATIC);
+                    return TCL_ERROR;
+                }
+                break;
+            }
+            case CHANNEL: {
+                int mode;
+                chan = Tcl_GetChannel(interp, Tcl_GetString(val), &mode);
+                if (chan == nullptr) {
+                    return TCL_ERROR;
+                }
+                if ((mode & TCL_READABLE) == 0) {
+                    Tcl_AppendResult(interp, "channel \"", Tcl_GetString(val), "\" wasn't opened for reading", nullptr);
+                    return TCL_ERROR;
+                }
+                break;
+            }
+            case DELIMITER: {
+                delimiter = val;
+                break;
+            }
+            case FORMAT: {
+                if (Tcl_GetIndexFromObj(interp, val, formats, "format", 0, (int*) &format) != TCL_OK) {
+                    return TCL_ERROR;
+                }
+                loadFormat.delimiter = (format == CSV ? ',' : '\t');
+                loadFormat.isQuoted  = (format == CSV);
+                break;
+            }
+            case NULLAS: {
+                loadFormat.nullStr = Tcl_GetStringFromObj(val, &loadFormat.nullLen);
+                break;
+            }
+        }
+    }
+    if (chan == nullptr) {
+        TclSetResult(interp, "-channel is required", TCL_STATIC);
+        return TCL_ERROR;
+    }
+    if (delimiter) {
+        int         len;
+        const char* str = Tcl_GetStringFromObj(delimiter, &len);
+        if (len != 1 || *str == '"' || *str == '\n') {
+            TclSetResult(interp, "delimiter must be a single ASCII character other than a quote or a newline", TCL_STATIC);
+            return TCL_ERROR;
+        }
+        loadFormat.delimiter = *str;
+    }
+
+    return stmt->load(interp, chan, loadFormat, batchSize);
+}
+
 int SdbConn::columns(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
 {
     if (objc > 4) {
@@ -430,13 +783,13 @@ int SdbConn::columns(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
     SdbStmt* stmt;
 
     if (objc == 2) {
-        stmt = myStmt();
+        stmt = implicitStmt();
     } else {
         int i = 2;
         if (Tcl_GetSdbStmtFromObj(objv[i], &stmt) == TCL_OK) {
             i++;
         } else {
-            stmt = myStmt();
+            stmt = implicitStmt();
         }
         if (i < objc) {
             if (Tcl_GetString(objv[i])[0] == '-') {
@@ -491,7 +844,31 @@ int SdbConn::execute(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
     SdbStmt* stmt;
     if (Tcl_GetSdbStmtFromObj(objv[i], &stmt) == TCL_OK) {
         i++;
+    } else if (i + 1 < objc) {
+        // SQL with arguments is prepared implicitly
+        setLastStmt(nullptr);
+        SdbPrepStmt* prepStmt;
+        if (i > 2) {
+            // statements with options are not cached as options change their state
+            auto newStmt = std::make_unique<SdbPrepStmt>(this);
+            if (newStmt->configure(interp, rsetConfig) != TCL_OK || newStmt->prepare(interp, objv[i]) != TCL_OK) {
+                return TCL_ERROR;
+            }
+            prepStmt = newStmt.release();
+        } else if (prepareCached(interp, objv[i], &prepStmt) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        setLastStmt(prepStmt);
+        return prepStmt->execute(interp, i + 1, objc, objv, rsetConfig);
     } else {
+        setLastStmt(nullptr);
+        if (autoParam && i == 2) {
+            bool isLifted;
+            int  rc = executeLifted(interp, objv[i], rsetConfig, &isLifted);
+            if (isLifted) {
+                return rc;
+            }
+        }
         stmt = myStmt();
     }
 
@@ -507,11 +884,14 @@ int SdbConn::fetch(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
         return TCL_ERROR;
     }
 
-    static const char* options[] = {"-asarray", "-first", "-last", "-next", "-previous", "-seek", NULL};
-    enum { ASARRAY, FIRST, LAST, NEXT, PREVIOUS, SEEK } opt;
+    static const char* options[] = {"-asarray", "-columns", "-first", "-last", "-limit", "-next", "-previous", "-rows", "-seek", NULL};
+    enum { ASARRAY, COLUMNS, FIRST, LAST, LIMIT, NEXT, PREVIOUS, ROWS, SEEK } opt;
 
-    int  row     = 0;
-    bool asArray = false;
+    int  row       = 0;
+    int  numRows   = 0;
+    int  limit     = 0;
+    bool asArray   = false;
+    bool asColumns = false;
 
     SdbStmt::SeekType seek = SdbStmt::SeekType::Next;
 
@@ -539,6 +919,28 @@ int SdbConn::fetch(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
                 }
                 break;
             }
+            case COLUMNS: asColumns = true; break;
+            case LIMIT:
+            case ROWS:    {
+                if (i == objc) {
+                    Tcl_AppendResult(interp, options[opt], " needs the number of rows", NULL);
+                    return TCL_ERROR;
+                }
+                int num;
+                if (Tcl_GetIntFromObj(interp, objv[i++], &num) != TCL_OK) {
+                    return TCL_ERROR;
+                }
+                if (num <= 0) {
+                    TclSetResult(interp, "number of rows must be positive", TCL_STATIC);
+                    return TCL_ERROR;
+                }
+                if (opt == ROWS) {
+                    numRows = num;
+                } else {
+                    limit = num;
+                }
+                break;
+            }
             case FIRST:    seek = SdbStmt::SeekType::First; break;
             case LAST:     seek = SdbStmt::SeekType::Last; break;
             case NEXT:     seek = SdbStmt::SeekType::Next; break;
@@ -555,7 +957,7 @@ int SdbConn::fetch(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
     if (Tcl_GetSdbStmtFromObj(objv[i], &stmt) == TCL_OK) {
         ++i;
     } else {
-        stmt = myStmt();
+        stmt = implicitStmt();
     }
 
     if (i >= objc) {
@@ -566,6 +968,21 @@ int SdbConn::fetch(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
     Tcl_Obj* rowVarName = objv[i++];
     Tcl_Obj* nullsVarName = i < objc ? objv[i] : nullptr;
 
+    if (numRows > 0 || asColumns) {
+        if (asArray || seek != SdbStmt::SeekType::Next || (numRows > 0 && asColumns)) {
+            TclSetResult(interp, "-rows and -columns fetch the next rows and cannot be combined with each other, -asarray, or cursor positioning options", TCL_STATIC);
+            return TCL_ERROR;
+        }
+        if (asColumns) {
+            return stmt->fetchColumns(interp, limit, rowVarName, nullsVarName);
+        }
+        return stmt->fetchRows(interp, numRows, rowVarName, nullsVarName);
+    }
+    if (limit > 0) {
+        TclSetResult(interp, "-limit can only be used with -columns", TCL_STATIC);
+        return TCL_ERROR;
+    }
+
     int rc = stmt->fetch(interp, seek, row);
     if (rc == TCL_OK) {
         if (stmt->getRowData(interp, rowVarName, nullsVarName, asArray) != TCL_OK) {
@@ -580,6 +997,133 @@ int SdbConn::fetch(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
     return TCL_OK;
 }
 
+/**
+ * State of the `foreach` loop that is kept between the evaluations of its body.
+ */
+struct ForeachLoop {
+    SdbConn* conn;
+    SdbStmt* stmt;
+    Tcl_Obj* stmtObj;
+    Tcl_Obj* rowVar;
+    Tcl_Obj* nullsVar;
+    Tcl_Obj* body;
+    bool     asArray;
+
+    ForeachLoop(SdbConn* conn, SdbStmt* stmt, Tcl_Obj* stmtObj, Tcl_Obj* rowVar, Tcl_Obj* nullsVar, Tcl_Obj* body, bool asArray)
+        : conn(conn), stmt(stmt), stmtObj(stmtObj), rowVar(rowVar), nullsVar(nullsVar), body(body), asArray(asArray)
+    {
+        Tcl_Preserve(conn);
+        // the body might replace the last statement of the connection
+        stmt->preserve();
+        if (stmtObj) Tcl_IncrRefCount(stmtObj);
+        Tcl_IncrRefCount(rowVar);
+        if (nullsVar) Tcl_IncrRefCount(nullsVar);
+        Tcl_IncrRefCount(body);
+    }
+
+    ~ForeachLoop()
+    {
+        Tcl_DecrRefCount(body);
+        if (nullsVar) Tcl_DecrRefCount(nullsVar);
+        Tcl_DecrRefCount(rowVar);
+        if (stmtObj) Tcl_DecrRefCount(stmtObj);
+        stmt->release();
+        Tcl_Release(conn);
+    }
+
+    /**
+     * Fetches the next row and schedules the evaluation of the loop body.
+     */
+    int next (Tcl_Interp* interp);
+};
+
+static int SdbConn_ForeachBodyDone (ClientData data[], Tcl_Interp* interp, int result)
+{
+    ForeachLoop* loop = (ForeachLoop*) data[0];
+    switch (result) {
+        case TCL_OK:
+        case TCL_CONTINUE: return loop->next(interp);
+        case TCL_BREAK:
+            Tcl_ResetResult(interp);
+            result = TCL_OK;
+            break;
+        case TCL_ERROR: Tcl_AppendObjToErrorInfo(interp, Tcl_ObjPrintf("\n    (\"foreach\" body line %d)", Tcl_GetErrorLine(interp))); break;
+    }
+    delete loop;
+    return result;
+}
+
+int ForeachLoop::next(Tcl_Interp* interp)
+{
+    int rc;
+    if (!stmt->hasResultSet()) {
+        TclSetResult(interp, "the result set was closed while iterating over it", TCL_STATIC);
+        rc = TCL_ERROR;
+    } else {
+        // the body might have resumed read-ahead of the LOBs with `read`
+        conn->pauseLobReads();
+        rc = stmt->fetch(interp, SdbStmt::SeekType::Next);
+    }
+    if (rc == TCL_OK) {
+        rc = stmt->getRowData(interp, rowVar, nullsVar, asArray);
+        if (rc == TCL_OK) {
+            Tcl_NRAddCallback(interp, SdbConn_ForeachBodyDone, this, nullptr, nullptr, nullptr);
+            return Tcl_NREvalObj(interp, body, 0);
+        }
+    } else if (rc == TCL_BREAK) {
+        Tcl_ResetResult(interp);
+        rc = TCL_OK;
+    }
+    delete this;
+    return rc;
+}
+
+int SdbConn::foreach(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
+{
+    if (objc < 4) {
+        // db foreach -asarray $stmt row nulls { ... }
+        Tcl_WrongNumArgs(interp, 2, objv, "?-asarray? ?stmt? rowVar ?nullIndVar? body");
+        return TCL_ERROR;
+    }
+
+    static const char* options[] = {"-asarray", NULL};
+
+    bool asArray = false;
+
+    int i = 2;
+    if (maybeOption(objv[i])) {
+        int opt;
+        if (Tcl_GetIndexFromObj(interp, objv[i++], options, "option", 0, &opt) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        asArray = true;
+    }
+
+    SdbStmt* stmt;
+    Tcl_Obj* stmtObj = nullptr;
+    if (i < objc && Tcl_GetSdbStmtFromObj(objv[i], &stmt) == TCL_OK) {
+        stmtObj = objv[i++];
+    } else {
+        stmt = implicitStmt();
+    }
+
+    if (objc - i < 2 || objc - i > 3) {
+        Tcl_WrongNumArgs(interp, 2, objv, "?-asarray? ?stmt? rowVar ?nullIndVar? body");
+        return TCL_ERROR;
+    }
+    if (!stmt->hasResultSet()) {
+        TclSetResult(interp, "the last executed SQL was not a query", TCL_STATIC);
+        return TCL_ERROR;
+    }
+
+    Tcl_Obj* rowVarName   = objv[i++];
+    Tcl_Obj* nullsVarName = objc - i == 2 ? objv[i++] : nullptr;
+    Tcl_Obj* body         = objv[i];
+
+    ForeachLoop* loop = new ForeachLoop(this, stmt, stmtObj, rowVarName, nullsVarName, body, asArray);
+    return loop->next(interp);
+}
+
 int SdbConn::rowNumber(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
 {
     if (objc != 2 && objc != 3) {
@@ -590,7 +1134,7 @@ int SdbConn::rowNumber(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
 
     SdbStmt* stmt;
     if (objc == 2) {
-        stmt = myStmt();
+        stmt = implicitStmt();
     } else if (Tcl_GetSdbStmtFromObj(objv[2], &stmt) != TCL_OK) {
         const char* typeName = objv[2]->typePtr ? objv[2]->typePtr->name : "string";
         Tcl_AppendResult(interp, "a statement handler is expected, but a ", typeName, " was given", nullptr);
@@ -610,22 +1154,22 @@ int SdbConn::serial(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
 {
     if (objc > 4) {
         // db serial -last $stmt
-        Tcl_WrongNumArgs(interp, 2, objv, "?-first|-last? ?stmtHandle?");
+        Tcl_WrongNumArgs(interp, 2, objv, "?-all|-first|-last? ?stmtHandle?");
         return TCL_ERROR;
     }
 
-    static const char* options[] = {"-first", "-last", NULL};
-    enum { FIRST, LAST } option  = LAST;
+    static const char* options[] = {"-all", "-first", "-last", NULL};
+    enum { ALL, FIRST, LAST } option = LAST;
 
     SdbStmt* stmt;
     if (objc == 2) {
-        stmt = myStmt();
+        stmt = implicitStmt();
     } else {
         int i = objc - 1;
         if (Tcl_GetSdbStmtFromObj(objv[i], &stmt) == TCL_OK) {
             --i;
         } else {
-            stmt = myStmt();
+            stmt = implicitStmt();
         }
         if (i == 2) {
             if (Tcl_GetIndexFromObj(interp, objv[i], options, "option", 0, (int*) &option) != TCL_OK) {
@@ -634,7 +1178,8 @@ int SdbConn::serial(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
         }
     }
 
-    return stmt->serial(interp, option == LAST);
+    SdbStmt::SerialKey keys[] = {SdbStmt::AllKeys, SdbStmt::FirstKey, SdbStmt::LastKey};
+    return stmt->serial(interp, keys[option]);
 }
 
 int SdbConn::close(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
@@ -706,39 +1251,154 @@ int SdbConn::position(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
 
 int SdbConn::read(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
 {
-    if (objc < 3 || objc > 6) {
-        // db read -from $pos $lob $numChars
-        Tcl_WrongNumArgs(interp, 2, objv, "?-from pos? lob numChars");
+    if (objc < 4) {
+        // db read -from $pos -into buf $lob $numChars
+        Tcl_WrongNumArgs(interp, 2, objv, "?-from pos? ?-into varName? lob numChars");
         return TCL_ERROR;
     }
 
+    static const char* options[] = {"-from", "-into", NULL};
+    enum { FROM, INTO } opt;
+
+    SQLDBC_Length position = 0;
+    Tcl_Obj*      varName  = nullptr;
+
+    int i = 2;
+    while (i < objc - 2) {
+        if (Tcl_GetIndexFromObj(interp, objv[i++], options, "option", 0, (int*) &opt) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        if (i == objc - 2) {
+            Tcl_AppendResult(interp, options[opt], " needs a value", NULL);
+            return TCL_ERROR;
+        }
+        switch (opt) {
+            case FROM: {
+                if (Tcl_GetWideIntFromObj(interp, objv[i++], &position) != TCL_OK) {
+                    return TCL_ERROR;
+                }
+                break;
+            }
+            case INTO: varName = objv[i++]; break;
+        }
+    }
+
     SdbLob* lob;
     if (Tcl_GetSdbLobFromObj(interp, objv[objc - 2], &lob) != TCL_OK) {
         return TCL_ERROR;
     }
+    pauseLobReads(lob);
 
     int length;
     if (Tcl_GetIntFromObj(interp, objv[objc - 1], &length) != TCL_OK) {
         return TCL_ERROR;
     }
+    if (length < 0) {
+        TclSetResult(interp, "number of chars to read cannot be negative", TCL_STATIC);
+        return TCL_ERROR;
+    }
 
-    SQLDBC_Length position = 0;
-    if (objc == 6) {
-        static const char* options[] = {"-from", NULL};
-        int                opt;
-        if (Tcl_GetIndexFromObj(interp, objv[2], options, "option", 0, &opt) != TCL_OK) {
+    // the buffer of the variable is reused if nothing else references it
+    Tcl_Obj* data = varName ? Tcl_ObjGetVar2(interp, varName, nullptr, 0) : nullptr;
+    if (data == nullptr || Tcl_IsShared(data) || (!lob->isBinary() && data->typePtr != nullptr)) {
+        data = Tcl_NewObj();
+    }
+    if (lob->read(interp, position, length, data) != TCL_OK) {
+        Tcl_IncrRefCount(data);
+        Tcl_DecrRefCount(data);
+        return TCL_ERROR;
+    }
+    if (varName == nullptr) {
+        Tcl_SetObjResult(interp, data);
+        return TCL_OK;
+    }
+
+    int numBytes;
+    if (lob->isBinary()) {
+        Tcl_GetByteArrayFromObj(data, &numBytes);
+    } else {
+        Tcl_GetStringFromObj(data, &numBytes);
+    }
+    if (Tcl_ObjSetVar2(interp, varName, nullptr, data, TCL_LEAVE_ERR_MSG) == nullptr) {
+        return TCL_ERROR;
+    }
+    Tcl_SetObjResult(interp, Tcl_NewIntObj(numBytes));
+    return TCL_OK;
+}
+
+int SdbConn::open(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
+{
+    if (objc < 3 || objc > 4) {
+        // db open $lob r
+        Tcl_WrongNumArgs(interp, 2, objv, "lob ?r|w?");
+        return TCL_ERROR;
+    }
+
+    SdbLob* lob;
+    if (Tcl_GetSdbLobFromObj(interp, objv[2], &lob) != TCL_OK) {
+        return TCL_ERROR;
+    }
+
+    static const char* modes[] = {"r", "w", NULL};
+    enum { READ, WRITE } mode  = READ;
+    if (objc == 4 && Tcl_GetIndexFromObj(interp, objv[3], modes, "mode", 0, (int*) &mode) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    if (!lob->isOpen()) {
+        TclSetResult(interp, "LOB is closed", TCL_STATIC);
+        return TCL_ERROR;
+    }
+
+    Tcl_Channel chan = lob->openChannel(interp, mode == READ ? TCL_READABLE : TCL_WRITABLE);
+    Tcl_SetObjResult(interp, Tcl_NewStringObj(Tcl_GetChannelName(chan), -1));
+    return TCL_OK;
+}
+
+int SdbConn::lobSource(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
+{
+    if (objc != 4) {
+        // db lobsource -file $path
+        Tcl_WrongNumArgs(interp, 2, objv, "-file path|-channel chan");
+        return TCL_ERROR;
+    }
+
+    static const char* options[] = {"-channel", "-file", NULL};
+    enum { CHANNEL, FILE_NAME } opt;
+    if (Tcl_GetIndexFromObj(interp, objv[2], options, "option", 0, (int*) &opt) != TCL_OK) {
+        return TCL_ERROR;
+    }
+
+    SdbLobSource* source = (opt == FILE_NAME ? SdbLobSource::mapFile(interp, objv[3]) : SdbLobSource::readChannel(interp, objv[3]));
+    if (source == nullptr) {
+        return TCL_ERROR;
+    }
+    Tcl_SetObjResult(interp, Tcl_NewSdbLobSourceObj(source));
+    return TCL_OK;
+}
+
+int SdbConn::readAhead(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
+{
+    if (objc < 3 || objc > 4) {
+        // db readahead $lob 2
+        Tcl_WrongNumArgs(interp, 2, objv, "lob ?depth?");
+        return TCL_ERROR;
+    }
+
+    SdbLob* lob;
+    if (Tcl_GetSdbLobFromObj(interp, objv[2], &lob) != TCL_OK) {
+        return TCL_ERROR;
+    }
+
+    if (objc == 4) {
+        int depth;
+        if (Tcl_GetIntFromObj(interp, objv[3], &depth) != TCL_OK) {
             return TCL_ERROR;
         }
-        if (Tcl_GetWideIntFromObj(interp, objv[3], &position) != TCL_OK) {
+        if (lob->setReadAheadDepth(interp, depth) != TCL_OK) {
             return TCL_ERROR;
         }
     }
-
-    Tcl_Obj* data;
-    if (lob->read(interp, position, length, &data) != TCL_OK) {
-        return TCL_ERROR;
-    }
-    Tcl_SetObjResult(interp, data);
+    Tcl_SetObjResult(interp, Tcl_NewIntObj(lob->getReadAheadDepth()));
     return TCL_OK;
 }
 
@@ -764,16 +1424,17 @@ int SdbConn::disconnect(Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
     return TCL_OK;
 }
 
-static int SdbConn_Cmd (SdbConn* sdbconn, Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
+static int SdbConn_NRCmd (SdbConn* sdbconn, Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
 {
     if (objc < 2) {
         Tcl_WrongNumArgs(interp, 1, objv, "stmt-handle|lob-handle|db-subcommand ?arg ... ?");
         return TCL_ERROR;
     }
 
-    static const char* subcommands[] = {"batch",   "close", "columns",  "commit",    "configure",    "disconnect",  "execute",
-                                        "fetch",   "get",   "is",       "length",    "newstatement", "optimalsize", "position",
-                                        "prepare", "read",  "rollback", "rownumber", "serial",       "write",       nullptr};
+    static const char* subcommands[] = {"batch",        "close",        "columns",      "commit",       "configure",    "disconnect",   "execute",
+                                        "executemany",  "fetch",        "foreach",      "get",          "is",           "length",       "load",
+                                        "lobsource",    "newstatement", "open",         "optimalsize",  "position",     "prepare",      "read",
+                                        "readahead",    "rollback",     "rownumber",    "serial",       "write",        nullptr};
     enum {
         BATCH,
         CLOSE,
@@ -782,15 +1443,21 @@ static int SdbConn_Cmd (SdbConn* sdbconn, Tcl_Interp* interp, int objc, Tcl_Obj*
         CONFIGURE,
         DISCONNECT,
         EXECUTE,
+        EXECUTEMANY,
         FETCH,
+        FOREACH,
         GET,
         IS,
         LENGTH,
+        LOAD,
+        LOBSOURCE,
         NEWSTATEMENT,
+        OPEN,
         OPTIMALSIZE,
         POSITION,
         PREPARE,
         READ,
+        READAHEAD,
         ROLLBACK,
         ROWNUMBER,
         SERIAL,
@@ -800,6 +1467,10 @@ static int SdbConn_Cmd (SdbConn* sdbconn, Tcl_Interp* interp, int objc, Tcl_Obj*
     if (Tcl_GetIndexFromObj(interp, objv[1], subcommands, "subcommand", 0, (int*) &subcommand) != TCL_OK) {
         return TCL_ERROR;
     }
+    // read-ahead threads use the connection only between reads of their LOBs
+    if (subcommand != READ) {
+        sdbconn->pauseLobReads();
+    }
     switch (subcommand) {
         case COMMIT:       return sdbconn->commit(interp);
         case CONFIGURE:    return sdbconn->configure(interp, objc, objv);
@@ -813,23 +1484,34 @@ static int SdbConn_Cmd (SdbConn* sdbconn, Tcl_Interp* interp, int objc, Tcl_Obj*
         case BATCH:        return sdbconn->batch(interp, objc, objv);
         case COLUMNS:      return sdbconn->columns(interp, objc, objv);
         case EXECUTE:      return sdbconn->execute(interp, objc, objv);
+        case EXECUTEMANY:  return sdbconn->executeMany(interp, objc, objv);
         case FETCH:        return sdbconn->fetch(interp, objc, objv);
+        case FOREACH:      return sdbconn->foreach(interp, objc, objv);
+        case LOAD:         return sdbconn->load(interp, objc, objv);
         case ROWNUMBER:    return sdbconn->rowNumber(interp, objc, objv);
         case SERIAL:       return sdbconn->serial(interp, objc, objv);
         // LOBs
         case CLOSE:        return sdbconn->close(interp, objc, objv);
         case LENGTH:       return sdbconn->length(interp, objc, objv);
+        case LOBSOURCE:    return sdbconn->lobSource(interp, objc, objv);
+        case OPEN:         return sdbconn->open(interp, objc, objv);
         case OPTIMALSIZE:  return sdbconn->optimalSize(interp, objc, objv);
         case POSITION:     return sdbconn->position(interp, objc, objv);
         case READ:         return sdbconn->read(interp, objc, objv);
+        case READAHEAD:    return sdbconn->readAhead(interp, objc, objv);
         case WRITE:        return sdbconn->write(interp, objc, objv);
     }
     return TCL_OK;
 }
 
+static int SdbConn_Cmd (SdbConn* sdbconn, Tcl_Interp* interp, int objc, Tcl_Obj* const objv[])
+{
+    return Tcl_NRCallObjProc(interp, (Tcl_ObjCmdProc*) SdbConn_NRCmd, sdbconn, objc, objv);
+}
+
 int SdbConn::createCommand(Tcl_Interp* interp, const char* name)
 {
-    cmd = Tcl_CreateObjCommand(interp, name, (Tcl_ObjCmdProc*) SdbConn_Cmd, this, (Tcl_CmdDeleteProc*) SdbConn_Delete);
+    cmd = Tcl_NRCreateCommand(interp, name, (Tcl_ObjCmdProc*) SdbConn_Cmd, (Tcl_ObjCmdProc*) SdbConn_NRCmd, this, (Tcl_CmdDeleteProc*) SdbConn_Delete);
     if (cmd == nullptr) {
         Tcl_AppendResult(interp, "cannot create ", name, " command", NULL);
         return TCL_ERROR;
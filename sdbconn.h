@@ -1,21 +1,130 @@
 #pragma once
 
 #include "sdbtcl.h"
+#include "sdbscan.h"
 #include <memory>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 
 class SdbStmt;
+class SdbPrepStmt;
+class SdbLob;
+struct ResultSetConfig;
+
+/**
+ * Bounded LRU cache of prepared statements keyed by their SQL text.
+ */
+class StmtCache {
+    typedef std::list<std::pair<std::string, SdbPrepStmt*>> Entries;
+
+    Entries                                                 entries;  /// the most recently used statements first
+    std::unordered_map<std::string_view, Entries::iterator> index;    /// keys reference SQL text of the entries
+    std::unordered_map<unsigned long, Entries::iterator>    stamps;   /// prepare stamps of the cached statements
+    size_t                                                  capacity;
+
+    /**
+     * Returns the statement of the entry and makes it the most recently used one, or returns NULL
+     * if the statement might be in use or its result set options were changed.
+     */
+    SdbPrepStmt* use (Entries::iterator entry);
+
+    /**
+     * Removes the entry and releases its statement.
+     */
+    void evict (Entries::iterator entry);
+
+    /**
+     * Removes the least recently used statements until the cache has no more than the given number of them.
+     */
+    void shrink (size_t size);
+
+public:
+    Tcl_WideInt hits;
+    Tcl_WideInt misses;
+
+    StmtCache() : capacity(0), hits(0), misses(0) {}
+    ~StmtCache() { clear(); }
+
+    StmtCache& operator= (const StmtCache&) = delete;
+
+    size_t getCapacity () { return capacity; }
+    size_t size () { return entries.size(); }
+
+    void setCapacity (size_t capacity);
+
+    /**
+     * Returns the cached statement for the SQL or NULL if the statement is not cached, if it
+     * is still referenced by TCL variables and thus might be in use, or if its result set
+     * options were changed.
+     */
+    SdbPrepStmt* get (const char* sql, int len);
+
+    /**
+     * Returns the cached statement with the given prepare stamp under the same conditions as `get`.
+     * Stamps are unique within the process, so statements of other connections are never found.
+     */
+    SdbPrepStmt* find (unsigned long stamp);
+
+    /**
+     * Adds the prepared statement to the cache replacing the statement that was cached for
+     * the same SQL and evicting the least recently used one if the cache is full.
+     */
+    void put (const char* sql, int len, SdbPrepStmt* stmt);
+
+    /**
+     * Releases all cached statements.
+     */
+    void clear ();
+};
 
 class SdbConn {
-    SQLDBC_Connection*           conn;    
-    SdbEnv&                      env;
-    Tcl_Command                  cmd;
-    SdbStmt*                     stmt;
-    std::unordered_set<SdbStmt*> statements;
+    SQLDBC_Connection*              conn;
+    SdbEnv&                         env;
+    Tcl_Command                     cmd;
+    SdbStmt*                        stmt;
+    SdbStmt*                        lastStmt;       /// prepared statement of the last `execute` of SQL with arguments
+    std::unordered_set<SdbStmt*>    statements;
+    StmtCache                       stmtCache;
+    SqlScanCache                    sqlScans;
+    bool                            autoParam;      /// literals of the unprepared DML are lifted into parameters
+    std::unordered_set<std::string> unliftable;     /// parameterized SQL that cannot be prepared
+    std::unordered_set<SdbLob*>     readAheadLobs;  /// LOBs which chunks are prefetched by the read-ahead threads
 
     SdbStmt* myStmt();
 
+    /**
+     * Returns the statement that holds the result of the last `execute` without explicit statement handle.
+     */
+    SdbStmt* implicitStmt () { return lastStmt ? lastStmt : myStmt(); }
+
+    /**
+     * Sets the prepared statement that was executed implicitly.
+     */
+    void setLastStmt (SdbStmt* stmt);
+
+    /**
+     * Returns the cached prepared statement for the SQL. If the statement is not cached, prepares
+     * it and adds it to the cache.
+     */
+    int prepareCached (Tcl_Interp* interp, Tcl_Obj* sql, SdbPrepStmt** stmtPtr);
+
+    /**
+     * Executes the SQL with its literals lifted into parameters of the cached prepared statement.
+     * Sets `isLiftedPtr` to false if literals cannot be lifted or if the parameterized SQL cannot
+     * be prepared, so the SQL needs to be executed as is. Errors of the lifted execution are
+     * returned as they are.
+     */
+    int executeLifted (Tcl_Interp* interp, Tcl_Obj* sql, ResultSetConfig& config, bool* isLiftedPtr);
+
 public:
+    /**
+     * Capacity of the statement cache that is enabled by `-autoparam` if the cache size is not set.
+     */
+    static const int AUTOPARAM_CACHE_SIZE = 100;
+
     SdbConn(SdbEnv& env);
     ~SdbConn();
 
@@ -29,11 +138,36 @@ public:
      */
     SQLDBC_PreparedStatement* createPreparedStatement();
 
+    /**
+     * Adds the statement to the tracking set, so its database handles are released when the connection is closed.
+     */
+    void addStatement (SdbStmt* stmt) { statements.insert(stmt); }
+
     /**
      * Removes the statement from the tracking set.
      */
     void eraseStatement (SdbStmt* stmt) { statements.erase(stmt); }
 
+    /**
+     * Adds the LOB which read-ahead thread uses the connection.
+     */
+    void addReadAheadLob (SdbLob* lob) { readAheadLobs.insert(lob); }
+
+    /**
+     * Removes the LOB which read-ahead thread has been stopped.
+     */
+    void eraseReadAheadLob (SdbLob* lob) { readAheadLobs.erase(lob); }
+
+    /**
+     * Waits until read-ahead threads, except the one of the given LOB, do not use the connection.
+     */
+    void pauseLobReads (SdbLob* except = nullptr);
+
+    /**
+     * Returns parameter markers of the SQL that is being prepared.
+     */
+    const SqlParams& scanParams (const char* sql, int len) { return sqlScans.scan(sql, len); }
+
     /**
      * Creates TCL command to control database connection
      */
@@ -116,6 +250,7 @@ public:
      * Retrieves database properties:
      *   - kernelversion
      *   - datetimeformat
+     *   - stmtcache (capacity, size, hits and misses of the prepared statements cache)
      *
      * Example:
      *
@@ -171,6 +306,9 @@ public:
      *    ORDER BY r.price
      * }]
      * ```
+     *
+     * When the connection has a statement cache, statements that are prepared without options are
+     * taken from the cache.
      */
     int prepare (Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]);
 
@@ -185,6 +323,30 @@ public:
      */
     int batch (Tcl_Interp* interp, int argc, Tcl_Obj* const argv[]);
 
+    /**
+     * Executes a prepared statement for each list of arguments.
+     *
+     * Arguments are sent to the server as arrays in batches of rows. Returns a list of row statuses.
+     *
+     * ```tcl
+     * set stmt [db prepare "INSERT INTO city (zip, name, state) VALUES (?, ?, ?)"]
+     * set rowStatus [db executemany -batch 500 $stmt $rows]
+     * ```
+     */
+    int executeMany (Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]);
+
+    /**
+     * Loads CSV or TSV records from a channel using a prepared INSERT statement.
+     *
+     * Returns the number of loaded and rejected records.
+     *
+     * ```tcl
+     * set stmt [db prepare "INSERT INTO city (zip, name, state) VALUES (?, ?, ?)"]
+     * set res [db load $stmt -channel $chan -format tsv -batch 5000]
+     * ```
+     */
+    int load (Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]);
+
     /**
      * Returns information about the result set columns.
      * 
@@ -218,6 +380,13 @@ public:
      *    ORDER BY r.price
      * "]
      * ```
+     *
+     * SQL with parameters can be executed without explicit statement handle. It is prepared (or
+     * taken from the statement cache) implicitly:
+     *
+     * ```tcl
+     * set numRows [db execute "UPDATE room SET price = price * ? WHERE hno = ?" 0.95 20]
+     * ```
      */
     int execute (Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]);
 
@@ -235,15 +404,38 @@ public:
      *
      * Data options:
      * - asarray   : the row will be stored as an array indexed by the labels of returned columns
+     * - rows num  : fetches up to `num` next rows at once and stores them as a list of row lists.
+     *               Returns the number of fetched rows.
+     * - columns   : fetches the remaining rows (or up to `-limit num` rows) and stores them as a
+     *               dictionary of column value lists. Returns the number of fetched rows.
      * 
      * ```tcl
      * while {[db fetch -asarray $stmt row]} {
      *   # ...
      * }
+     * while {[db fetch -rows 1000 $stmt rows]} {
+     *   foreach row $rows {
+     *     # ...
+     *   }
+     * }
      * ```
      */
     int fetch (Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]);
 
+    /**
+     * Evaluates the script for each row of the result set.
+     *
+     * Rows are fetched and saved into the row variable (and null indicators, if the variable for
+     * them is provided) the same way `fetch` does it. The script can use `break` and `continue`.
+     *
+     * ```tcl
+     * db foreach -asarray $stmt row {
+     *   # ...
+     * }
+     * ```
+     */
+    int foreach (Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]);
+
     /**
      * Returns the current row number.
      *
@@ -257,6 +449,7 @@ public:
      * Retrieves the key that was inserted by the last insert operation.
      *
      * Options:
+     * - all   : return all keys that were generated by the last (bulk) execution
      * - first : return the first serial key
      * - last  : return the last serial key (default)
      * 
@@ -307,6 +500,27 @@ public:
      */
     int position (Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]);
 
+    /**
+     * Opens a channel that reads the LOB content or writes into the LOB.
+     *
+     * ```tcl
+     * set chan [db open $lob]
+     * chan copy $chan $file -command done
+     * ```
+     */
+    int open (Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]);
+
+    /**
+     * Creates a source of a LONG parameter value that is streamed from the memory-mapped file or
+     * from the channel when the statement is executed.
+     *
+     * ```tcl
+     * set stmt [db prepare "INSERT INTO docs (id, doc) VALUES (:ID, :DOC)"]
+     * db execute $stmt :ID $id :DOC [db lobsource -file $path]
+     * ```
+     */
+    int lobSource (Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]);
+
     /**
      * Retrieves the (poosibly partial) content of the LOB.
      *
@@ -319,6 +533,19 @@ public:
      */
     int read (Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]);
 
+    /**
+     * Sets, or returns, the number of chunks that a background thread reads ahead while the script
+     * consumes the chunk returned by `read`.
+     *
+     * ```tcl
+     * db readahead $lob 2
+     * while {[db read -into chunk $lob 1048576] > 0} {
+     *     puts -nonewline $out $chunk
+     * }
+     * ```
+     */
+    int readAhead (Tcl_Interp* interp, int objc, Tcl_Obj* const objv[]);
+
     /**
      * Puts data into the given LOB starting at the current position.
      *
@@ -0,0 +1,96 @@
+#include "sdbload.h"
+#include <cstring>
+
+RecordReader::RecordReader(Tcl_Channel chan, const LoadFormat& format) : chan(chan), format(format)
+{
+    line = Tcl_NewObj();
+    Tcl_IncrRefCount(line);
+}
+
+RecordReader::~RecordReader()
+{
+    Tcl_DecrRefCount(line);
+}
+
+int RecordReader::readLine(Tcl_Interp* interp)
+{
+    Tcl_SetObjLength(line, 0);
+    if (Tcl_GetsObj(chan, line) >= 0) {
+        return 1;
+    }
+    if (Tcl_Eof(chan)) {
+        return 0;
+    }
+    if (Tcl_InputBlocked(chan)) {
+        TclSetResult(interp, "cannot load data from a non-blocking channel", TCL_STATIC);
+    } else {
+        Tcl_AppendResult(interp, "error reading channel: ", Tcl_PosixError(interp), nullptr);
+    }
+    return -1;
+}
+
+void RecordReader::endField(std::string& text, FieldRef& field, bool isQuoted, std::vector<FieldRef>& fields)
+{
+    field.length = text.size() - field.offset;
+    field.isNull = !isQuoted && field.length == format.nullLen && std::memcmp(text.data() + field.offset, format.nullStr, field.length) == 0;
+    text.push_back('\0');
+    fields.push_back(field);
+}
+
+int RecordReader::read(Tcl_Interp* interp, std::string& text, std::vector<FieldRef>& fields)
+{
+    int         rc;
+    int         len;
+    const char* str;
+    do {
+        if ((rc = readLine(interp)) <= 0) {
+            return rc;
+        }
+        str = Tcl_GetStringFromObj(line, &len);
+    } while (len == 0);  // blank lines are skipped
+
+    FieldRef field    = {text.size(), 0, false};
+    bool     isQuoted = false;  // the field has been enclosed in quotes
+    bool     inQuotes = false;  // the scanner is inside the quoted text
+
+    for (;;) {
+        const char* end = str + len;
+        for (const char* p = str; p < end; p++) {
+            char c = *p;
+            if (inQuotes) {
+                if (c != '"') {
+                    text.push_back(c);
+                } else if (p + 1 < end && p[1] == '"') {
+                    text.push_back(c);
+                    ++p;
+                } else {
+                    inQuotes = false;
+                }
+            } else if (c == format.delimiter) {
+                endField(text, field, isQuoted, fields);
+                field.offset = text.size();
+                isQuoted     = false;
+            } else if (c == '"' && format.isQuoted && !isQuoted && text.size() == field.offset) {
+                isQuoted = inQuotes = true;
+            } else {
+                text.push_back(c);
+            }
+        }
+        if (!inQuotes) {
+            break;
+        }
+        // quoted text continues on the next line
+        if ((rc = readLine(interp)) < 0) {
+            return rc;
+        }
+        if (rc == 0) {
+            TclSetResult(interp, "malformed input: quoted field is not terminated at the end of the input", TCL_STATIC);
+            return -1;
+        }
+        text.push_back('\n');
+        str = Tcl_GetStringFromObj(line, &len);
+    }
+
+    endField(text, field, isQuoted, fields);
+    return 1;
+}
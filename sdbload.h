@@ -0,0 +1,61 @@
+#pragma once
+
+#include "sdbtcl.h"
+#include <string>
+#include <vector>
+
+/**
+ * Format of the delimited text records that are loaded by `load`.
+ */
+struct LoadFormat {
+    char        delimiter;
+    bool        isQuoted;  /// CSV fields can be enclosed in double quotes
+    const char* nullStr;   /// unquoted fields with this text are loaded as NULL
+    int         nullLen;
+
+    LoadFormat () : delimiter(','), isQuoted(true), nullStr(""), nullLen(0) {}
+};
+
+/**
+ * Location of the field's text in the record text buffer.
+ */
+struct FieldRef {
+    size_t offset;
+    int    length;
+    bool   isNull;
+};
+
+/**
+ * Reads delimited text records from a channel.
+ */
+class RecordReader {
+    Tcl_Channel chan;
+    LoadFormat  format;
+    Tcl_Obj*    line;
+
+    /**
+     * Reads the next line. Returns 1 if the line was read, 0 at the end of the input and -1 if
+     * it cannot be read.
+     */
+    int readLine (Tcl_Interp* interp);
+
+    /**
+     * Completes the field which text has been appended to the text buffer.
+     */
+    void endField (std::string& text, FieldRef& field, bool isQuoted, std::vector<FieldRef>& fields);
+
+public:
+    RecordReader(Tcl_Channel chan, const LoadFormat& format);
+    ~RecordReader();
+
+    RecordReader& operator= (const RecordReader&) = delete;
+
+    /**
+     * Reads the next record. Unescaped text of each field, followed by a NUL, is appended to the text
+     * and field locations are appended to the fields.
+     *
+     * Returns 1 if the record was read, 0 at the end of the input and -1 if the input cannot be read
+     * or if it ends inside a quoted field.
+     */
+    int read (Tcl_Interp* interp, std::string& text, std::vector<FieldRef>& fields);
+};
@@ -1,46 +1,183 @@
 #include "sdblob.h"
 #include "sdbstmt.h"
+#include "sdbconn.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+
+/**
+ * Part of the LOB that was read by the read-ahead thread.
+ */
+struct LobChunk {
+    char*         data;
+    SQLDBC_Length length;    /// number of bytes read, 0 at the end of the LOB or -1 if the LOB cannot be read
+    SQLDBC_Length position;  /// where the chunk starts in the LOB
+};
+
+/**
+ * State that the read-ahead thread shares with the interpreter thread. All fields, except the thread
+ * ID, are guarded by the mutex.
+ */
+struct LobReadAhead {
+    SdbConn*             conn;         /// connection that the thread uses
+    Tcl_ThreadId         thread;
+    Tcl_Mutex            mutex;
+    Tcl_Condition        changed;      /// signals new chunks to the interpreter and new requests to the thread
+    std::deque<LobChunk> chunks;       /// prefetched chunks in the LOB order
+    int                  depth;        /// maximum number of prefetched chunks
+    int                  chunkLength;  /// length that the script reads, 0 until the first read
+    bool                 isPaused;     /// the thread may not start reading the next chunk
+    bool                 isReading;    /// the thread is reading the chunk
+    bool                 isStopping;   /// the thread should exit
+    bool                 atEnd;        /// the last chunk was the end of the LOB or a read error
+
+    LobReadAhead(SdbConn* conn, int depth) : conn(conn), thread(nullptr), mutex(nullptr), changed(nullptr), depth(depth), chunkLength(0), isPaused(true), isReading(false), isStopping(false), atEnd(false) {}
+    ~LobReadAhead()
+    {
+        discardChunks();
+        Tcl_ConditionFinalize(&changed);
+        Tcl_MutexFinalize(&mutex);
+    }
+
+    void discardChunks ()
+    {
+        for (auto it = chunks.begin(); it != chunks.end(); ++it) {
+            if (it->data) Tcl_Free(it->data);
+        }
+        chunks.clear();
+    }
+};
+
+/**
+ * Resizes the byte array like Tcl_SetByteArrayLength, but returns NULL instead of panicking
+ * when the memory for the array cannot be allocated.
+ */
+static unsigned char* attemptSetByteArrayLength (Tcl_Obj* obj, int length)
+{
+    // TCL has no allocation failure tolerant variant of Tcl_SetByteArrayLength, so the memory
+    // for the array and its header is tried first
+    char* probe = Tcl_AttemptAlloc((unsigned int) length + 16);
+    if (probe == nullptr) {
+        return nullptr;
+    }
+    Tcl_Free(probe);
+    return Tcl_SetByteArrayLength(obj, length);
+}
+
+SQLDBC_Length SdbLob::getData(char* buffer, SQLDBC_Length size, SQLDBC_Length position)
+{
+    SQLDBC_Length  bytesRead;
+    SQLDBC_Retcode rc = position == 0
+        ? lob.getData(buffer, &bytesRead, size)
+        : lob.getData(buffer, &bytesRead, size, position);
+    switch (rc) {
+        case SQLDBC_OK:            return bytesRead == SQLDBC_NULL_DATA ? 0 : bytesRead;
+        case SQLDBC_NO_DATA_FOUND: return 0;
+        // the buffer is full, and the length indicator has the length of the remaining data
+        case SQLDBC_DATA_TRUNC:    return lobType == SQLDBC_HOSTTYPE_BLOB ? size : strnlen(buffer, size);
+        default:                   return -1;
+    }
+}
+
+bool SdbLob::putData(const char* data, SQLDBC_Length length)
+{
+    return lob.putData((void*) data, &length) != SQLDBC_NOT_OK;
+}
+
+SdbLob::SdbLob(SQLDBC_LOB lob, SQLDBC_HostType lobType, SdbStmt& stmt) : stmt(stmt), lob(lob), lobType(lobType), isLobOpen(true), refCount(0), readAhead(nullptr)
+{
+    // the statement provides the connection which read-ahead is paused when the LOB is used
+    stmt.preserve();
+}
+
+SdbLob::~SdbLob()
+{
+    closeQuietly();
+    stmt.release();
+}
 
 int SdbLob::write(Tcl_Interp* interp, Tcl_Obj* obj)
 {
-    int   length;
-    void* data;
+    int         length;
+    const char* data;
     if (lobType == SQLDBC_HOSTTYPE_BLOB) {
-        data = Tcl_GetByteArrayFromObj(obj, &length);
+        data = (const char*) Tcl_GetByteArrayFromObj(obj, &length);
     } else {
         data = Tcl_GetStringFromObj(obj, &length);
     }
-    SQLDBC_Length dataLen = length;
-    if (lob.putData(data, &dataLen) == SQLDBC_NOT_OK) {
+    if (!putData(data, length)) {
         TclSetResult(interp, "error writing to LOB", TCL_STATIC);
         return TCL_ERROR;
     }
     return TCL_OK;
 }
 
-int SdbLob::read(Tcl_Interp* interp, SQLDBC_Length position, int length, Tcl_Obj** objPtr)
+int SdbLob::read(Tcl_Interp* interp, SQLDBC_Length position, int length, Tcl_Obj* obj)
 {
-    char bytes[lobType == SQLDBC_HOSTTYPE_BLOB ? length : length + 1];
-    SQLDBC_Length  bytesRead;
-    SQLDBC_Retcode rc = position == 0
-        ? lob.getData(bytes, &bytesRead, sizeof(bytes))
-        : lob.getData(bytes, &bytesRead, sizeof(bytes), position);
-    if (rc == SQLDBC_NOT_OK) {
-        TclSetResult(interp, "error reading LOB", TCL_STATIC);
+    if (readAhead) {
+        if (position == 0 && length > 0 && length == readAhead->chunkLength) {
+            return takeChunk(interp, obj);
+        }
+        position = restartReadAhead(position, length);
+    }
+    char* buffer = nullptr;
+    if (lobType == SQLDBC_HOSTTYPE_BLOB) {
+        buffer = (char*) attemptSetByteArrayLength(obj, length);
+        if (buffer == nullptr) {
+            // the requested length might be much larger than the rest of the LOB
+            SQLDBC_Length remaining = lob.getLength() - (position > 0 ? position : lob.getPosition()) + 1;
+            if (0 < remaining && remaining < length) {
+                length = (int) remaining;
+                buffer = (char*) attemptSetByteArrayLength(obj, length);
+            }
+        }
+    } else if (Tcl_AttemptSetObjLength(obj, length)) {
+        buffer = obj->bytes;
+    }
+    if (buffer == nullptr) {
+        if (interp) TclSetResult(interp, "cannot allocate LOB read buffer", TCL_STATIC);
         return TCL_ERROR;
     }
-    if (rc == SQLDBC_NO_DATA_FOUND || bytesRead == SQLDBC_NULL_DATA) {
-        *objPtr = Tcl_NewObj();
-    } else if (lobType == SQLDBC_HOSTTYPE_BLOB) {
-        *objPtr = Tcl_NewByteArrayObj((unsigned char*) bytes, bytesRead);
+    // string buffer has room for the terminating NUL
+    SQLDBC_Length bytesRead = getData(buffer, lobType == SQLDBC_HOSTTYPE_BLOB ? length : length + 1, position);
+    if (lobType == SQLDBC_HOSTTYPE_BLOB) {
+        Tcl_SetByteArrayLength(obj, bytesRead > 0 ? bytesRead : 0);
     } else {
-        *objPtr = Tcl_NewStringObj(bytes, bytesRead);
+        Tcl_SetObjLength(obj, bytesRead > 0 ? bytesRead : 0);
+    }
+    if (bytesRead < 0) {
+        if (interp) TclSetResult(interp, "error reading LOB", TCL_STATIC);
+        return TCL_ERROR;
+    }
+    if (readAhead) {
+        resumeReadAhead();
     }
     return TCL_OK;
 }
 
+Tcl_Obj* SdbLob::readInline(SQLDBC_Length limit)
+{
+    SQLDBC_Length length = lob.getLength();
+    if (length < 0 || length >= limit) {
+        return nullptr;
+    }
+    // CLOB length is in characters, and each one takes no more than TCL_UTF_MAX bytes in UTF-8
+    Tcl_Obj* value = Tcl_NewObj();
+    int      size;
+    if (read(nullptr, 1, lobType == SQLDBC_HOSTTYPE_BLOB ? length : length * TCL_UTF_MAX, value) != TCL_OK
+        || (lobType == SQLDBC_HOSTTYPE_BLOB && (Tcl_GetByteArrayFromObj(value, &size), size != length))) {
+        Tcl_IncrRefCount(value);
+        Tcl_DecrRefCount(value);
+        return nullptr;
+    }
+    return value;
+}
+
 int SdbLob::close(Tcl_Interp* interp)
 {
+    stopReadAhead();
+    pauseConnectionReads();
     if (lob.close() != SQLDBC_OK) {
         TclSetResult(interp, "error closing LOB", TCL_STATIC);
         return TCL_ERROR;
@@ -52,6 +189,309 @@ int SdbLob::close(Tcl_Interp* interp)
 
 // ------------------------------------------------------------------------------------------------
 
+Tcl_ThreadCreateType SdbLob::readAheadProc(ClientData clientData)
+{
+    SdbLob*       lob = (SdbLob*) clientData;
+    LobReadAhead* ra  = lob->readAhead;
+
+    Tcl_MutexLock(&ra->mutex);
+    while (!ra->isStopping) {
+        if (ra->isPaused || ra->atEnd || ra->chunks.size() >= (size_t) ra->depth) {
+            Tcl_ConditionWait(&ra->changed, &ra->mutex, nullptr);
+            continue;
+        }
+        // string buffer has room for the terminating NUL
+        SQLDBC_Length size = (lob->lobType == SQLDBC_HOSTTYPE_BLOB ? ra->chunkLength : ra->chunkLength + 1);
+        ra->isReading      = true;
+        Tcl_MutexUnlock(&ra->mutex);
+
+        LobChunk chunk;
+        chunk.position = lob->lob.getPosition();
+        chunk.data     = Tcl_AttemptAlloc(size);
+        chunk.length   = (chunk.data ? lob->getData(chunk.data, size) : -1);
+
+        Tcl_MutexLock(&ra->mutex);
+        ra->chunks.push_back(chunk);
+        ra->isReading = false;
+        ra->atEnd     = chunk.length <= 0;
+        Tcl_ConditionNotify(&ra->changed);
+    }
+    Tcl_MutexUnlock(&ra->mutex);
+    TCL_THREAD_CREATE_RETURN;
+}
+
+int SdbLob::takeChunk(Tcl_Interp* interp, Tcl_Obj* obj)
+{
+    LobReadAhead* ra = readAhead;
+
+    Tcl_MutexLock(&ra->mutex);
+    ra->isPaused = false;
+    Tcl_ConditionNotify(&ra->changed);
+    while (ra->chunks.empty() && !ra->atEnd) {
+        Tcl_ConditionWait(&ra->changed, &ra->mutex, nullptr);
+    }
+    LobChunk chunk = {nullptr, 0, 0};
+    if (!ra->chunks.empty()) {
+        chunk = ra->chunks.front();
+        ra->chunks.pop_front();
+        // the freed slot is refilled while the script consumes this chunk
+        Tcl_ConditionNotify(&ra->changed);
+    }
+    Tcl_MutexUnlock(&ra->mutex);
+
+    SQLDBC_Length length = (chunk.length > 0 ? chunk.length : 0);
+    char*         buffer = nullptr;
+    if (lobType == SQLDBC_HOSTTYPE_BLOB) {
+        buffer = (char*) attemptSetByteArrayLength(obj, length);
+    } else if (Tcl_AttemptSetObjLength(obj, length)) {
+        buffer = obj->bytes;
+    }
+    if (buffer == nullptr) {
+        Tcl_Free(chunk.data);
+        if (interp) TclSetResult(interp, "cannot allocate LOB read buffer", TCL_STATIC);
+        return TCL_ERROR;
+    }
+    if (chunk.data) {
+        std::memcpy(buffer, chunk.data, length);
+        Tcl_Free(chunk.data);
+    }
+    if (chunk.length < 0) {
+        if (interp) TclSetResult(interp, "error reading LOB", TCL_STATIC);
+        return TCL_ERROR;
+    }
+    return TCL_OK;
+}
+
+SQLDBC_Length SdbLob::restartReadAhead(SQLDBC_Length position, int length)
+{
+    pauseReadAhead();
+    LobReadAhead* ra = readAhead;
+
+    Tcl_MutexLock(&ra->mutex);
+    if (position == 0 && !ra->chunks.empty()) {
+        position = ra->chunks.front().position;
+    }
+    ra->discardChunks();
+    ra->chunkLength = length;
+    ra->atEnd       = false;
+    Tcl_MutexUnlock(&ra->mutex);
+    return position;
+}
+
+void SdbLob::resumeReadAhead()
+{
+    LobReadAhead* ra = readAhead;
+
+    Tcl_MutexLock(&ra->mutex);
+    ra->isPaused = ra->chunkLength <= 0;
+    Tcl_ConditionNotify(&ra->changed);
+    Tcl_MutexUnlock(&ra->mutex);
+}
+
+void SdbLob::pauseReadAhead()
+{
+    LobReadAhead* ra = readAhead;
+    if (ra == nullptr) {
+        return;
+    }
+    Tcl_MutexLock(&ra->mutex);
+    ra->isPaused = true;
+    while (ra->isReading) {
+        Tcl_ConditionWait(&ra->changed, &ra->mutex, nullptr);
+    }
+    Tcl_MutexUnlock(&ra->mutex);
+}
+
+void SdbLob::stopReadAhead()
+{
+    LobReadAhead* ra = readAhead;
+    if (ra == nullptr) {
+        return;
+    }
+    Tcl_MutexLock(&ra->mutex);
+    ra->isStopping = true;
+    Tcl_ConditionNotify(&ra->changed);
+    Tcl_MutexUnlock(&ra->mutex);
+
+    int result;
+    Tcl_JoinThread(ra->thread, &result);
+    ra->conn->eraseReadAheadLob(this);
+    delete ra;
+    readAhead = nullptr;
+}
+
+void SdbLob::pauseConnectionReads()
+{
+    SdbConn* conn = stmt.getConnection();
+    if (conn) {
+        conn->pauseLobReads();
+    }
+}
+
+int SdbLob::setReadAheadDepth(Tcl_Interp* interp, int depth)
+{
+    if (depth < 0 || depth > MAX_READ_AHEAD_DEPTH) {
+        Tcl_SetObjResult(interp, Tcl_ObjPrintf("read-ahead depth must be between 0 and %d", MAX_READ_AHEAD_DEPTH));
+        return TCL_ERROR;
+    }
+    if (depth == 0) {
+        stopReadAhead();
+        return TCL_OK;
+    }
+    if (readAhead) {
+        Tcl_MutexLock(&readAhead->mutex);
+        readAhead->depth = depth;
+        Tcl_ConditionNotify(&readAhead->changed);
+        Tcl_MutexUnlock(&readAhead->mutex);
+        return TCL_OK;
+    }
+    SdbConn* conn = stmt.getConnection();
+    if (conn == nullptr || !isLobOpen) {
+        TclSetResult(interp, "LOB is closed", TCL_STATIC);
+        return TCL_ERROR;
+    }
+    readAhead = new LobReadAhead(conn, depth);
+    if (Tcl_CreateThread(&readAhead->thread, readAheadProc, this, TCL_THREAD_STACK_DEFAULT, TCL_THREAD_JOINABLE) != TCL_OK) {
+        delete readAhead;
+        readAhead = nullptr;
+        TclSetResult(interp, "cannot start LOB read-ahead thread", TCL_STATIC);
+        return TCL_ERROR;
+    }
+    conn->addReadAheadLob(this);
+    return TCL_OK;
+}
+
+int SdbLob::getReadAheadDepth()
+{
+    return readAhead ? readAhead->depth : 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+
+/**
+ * State of the channel that streams the LOB.
+ */
+struct LobChannel {
+    SdbLob*        lob;
+    Tcl_Channel    chan;
+    Tcl_TimerToken timer;      /// pending notification of the channel readiness
+    int            watchMask;  /// events the channel is interested in
+};
+
+static int lobChannelClose (ClientData instanceData, Tcl_Interp* interp)
+{
+    LobChannel* lobChan = (LobChannel*) instanceData;
+    if (lobChan->timer) {
+        Tcl_DeleteTimerHandler(lobChan->timer);
+    }
+    // the LOB is closed when the channel holds its last reference
+    lobChan->lob->pauseConnectionReads();
+    lobChan->lob->release();
+    Tcl_Free((char*) lobChan);
+    return 0;
+}
+
+static int lobChannelInput (ClientData instanceData, char* buf, int toRead, int* errorCodePtr)
+{
+    SdbLob* lob = ((LobChannel*) instanceData)->lob;
+    if (!lob->isOpen()) {
+        *errorCodePtr = EBADF;
+        return -1;
+    }
+    lob->pauseConnectionReads();
+    SQLDBC_Length bytesRead = lob->getData(buf, toRead);
+    if (bytesRead < 0) {
+        *errorCodePtr = EIO;
+        return -1;
+    }
+    return bytesRead;
+}
+
+static int lobChannelOutput (ClientData instanceData, const char* buf, int toWrite, int* errorCodePtr)
+{
+    SdbLob* lob = ((LobChannel*) instanceData)->lob;
+    if (!lob->isOpen()) {
+        *errorCodePtr = EBADF;
+        return -1;
+    }
+    lob->pauseConnectionReads();
+    if (!lob->putData(buf, toWrite)) {
+        *errorCodePtr = EIO;
+        return -1;
+    }
+    return toWrite;
+}
+
+/**
+ * LOB is always ready to be read or written, so the channel notifies its watchers from the event loop.
+ */
+static void lobChannelReady (ClientData clientData)
+{
+    LobChannel* lobChan = (LobChannel*) clientData;
+    lobChan->timer      = nullptr;
+    if (lobChan->watchMask) {
+        Tcl_NotifyChannel(lobChan->chan, lobChan->watchMask);
+    }
+}
+
+static void lobChannelWatch (ClientData instanceData, int mask)
+{
+    LobChannel* lobChan = (LobChannel*) instanceData;
+    lobChan->watchMask  = mask & (TCL_READABLE | TCL_WRITABLE);
+    if (lobChan->watchMask && !lobChan->timer) {
+        lobChan->timer = Tcl_CreateTimerHandler(0, lobChannelReady, lobChan);
+    } else if (!lobChan->watchMask && lobChan->timer) {
+        Tcl_DeleteTimerHandler(lobChan->timer);
+        lobChan->timer = nullptr;
+    }
+}
+
+static int lobChannelGetHandle (ClientData instanceData, int direction, ClientData* handlePtr)
+{
+    return TCL_ERROR;
+}
+
+static Tcl_ChannelType lobChannelType = {
+    .typeName      = (char*) "sdblob",
+    .version       = TCL_CHANNEL_VERSION_5,
+    .closeProc     = lobChannelClose,
+    .inputProc     = lobChannelInput,
+    .outputProc    = lobChannelOutput,
+    .watchProc     = lobChannelWatch,
+    .getHandleProc = lobChannelGetHandle,
+};
+
+Tcl_Channel SdbLob::openChannel(Tcl_Interp* interp, int mode)
+{
+    static int lastChannelNo = 0;
+
+    char name[24];
+    snprintf(name, sizeof(name), "sdblob%d", ++lastChannelNo);
+
+    LobChannel* lobChan = (LobChannel*) Tcl_Alloc(sizeof(LobChannel));
+    lobChan->lob        = this;
+    lobChan->timer      = nullptr;
+    lobChan->watchMask  = 0;
+    lobChan->chan       = Tcl_CreateChannel(&lobChannelType, name, lobChan, mode);
+    preserve();
+
+    // buffers of the preferred size are transferred in one round trip
+    SQLDBC_Length bufferSize = lob.getPreferredDataSize();
+    if (bufferSize > 0) {
+        Tcl_SetChannelBufferSize(lobChan->chan, bufferSize);
+    }
+    if (lobType == SQLDBC_HOSTTYPE_BLOB) {
+        Tcl_SetChannelOption(interp, lobChan->chan, "-translation", "binary");
+    } else {
+        Tcl_SetChannelOption(interp, lobChan->chan, "-encoding", "utf-8");
+        Tcl_SetChannelOption(interp, lobChan->chan, "-translation", "lf");
+    }
+    Tcl_RegisterChannel(interp, lobChan->chan);
+    return lobChan->chan;
+}
+
+// ------------------------------------------------------------------------------------------------
+
 static void freeIntRep (Tcl_Obj* obj)
 {
     SdbLob* lob = (SdbLob*) obj->internalRep.otherValuePtr;
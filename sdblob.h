@@ -3,22 +3,42 @@
 #include "sdbtcl.h"
 
 class SdbStmt;
+struct LobReadAhead;
 
 class SdbLob {
-    SQLDBC_LOB lob;
-    SdbStmt&   stmt;
-    int        refCount;
+    SQLDBC_LOB    lob;
+    SdbStmt&      stmt;
+    int           refCount;
+    LobReadAhead* readAhead;  /// chunks prefetched by the read-ahead thread or NULL when the LOB is read synchronously
     struct {
         SQLDBC_HostType lobType : 8;
         bool            isLobOpen : 8;
     };
 
+    /**
+     * Reads the next chunks of the LOB in the background.
+     */
+    static Tcl_ThreadCreateType readAheadProc (ClientData clientData);
+
+    /**
+     * Moves the oldest prefetched chunk into the object.
+     */
+    int takeChunk (Tcl_Interp* interp, Tcl_Obj* obj);
+
+    /**
+     * Discards prefetched chunks before the LOB is read synchronously. Returns the position to read
+     * from, which is the start of the first discarded chunk if the position is 0.
+     */
+    SQLDBC_Length restartReadAhead (SQLDBC_Length position, int length);
+
+    /**
+     * Lets the read-ahead thread prefetch the chunks that follow the one just read.
+     */
+    void resumeReadAhead ();
+
 public:
-    SdbLob(SQLDBC_LOB lob, SQLDBC_HostType lobType, SdbStmt& stmt) : stmt(stmt), lob(lob), lobType(lobType), isLobOpen(true), refCount(0) {}
-    ~SdbLob()
-    {
-        if (isLobOpen) lob.close();
-    }
+    SdbLob(SQLDBC_LOB lob, SQLDBC_HostType lobType, SdbStmt& stmt);
+    ~SdbLob();
 
     void preserve () { ++refCount; }
     void release ()
@@ -29,6 +49,21 @@ public:
     }
 
     bool isOpen () { return isLobOpen; }
+    bool isBinary () { return lobType == SQLDBC_HOSTTYPE_BLOB; }
+
+    /**
+     * Reads the next part of the LOB into the buffer. Character data are terminated, thus for
+     * CLOBs the buffer should have room for the NUL.
+     *
+     * Returns the number of bytes that were read, 0 at the end of the LOB or -1 if the LOB cannot
+     * be read. Reading starts at the current position if the position is 0.
+     */
+    SQLDBC_Length getData (char* buffer, SQLDBC_Length size, SQLDBC_Length position = 0);
+
+    /**
+     * Writes data into the LOB at the current position. Returns false if the data cannot be written.
+     */
+    bool putData (const char* data, SQLDBC_Length length);
 
     /**
      * Retrieves the length of this LOB in the database. The length is returned in chars.
@@ -55,17 +90,76 @@ public:
     int write (Tcl_Interp* interp, Tcl_Obj* obj);
 
     /**
-     * Retrieves the (poosibly partial) content of the LOB.
+     * Retrieves the (poosibly partial) content of the LOB into the unshared object. The error
+     * message is left in the interpreter result if the interpreter is provided. The object becomes
+     * a byte array for BLOBs and a string for CLOBs. Its existing buffer is reused when
+     * it is large enough.
      *
      * After the operation, the internal position is the start position
      * plus the number of bytes/characters that have been read.
      */
-    int read (Tcl_Interp* interp, SQLDBC_Length position, int length, Tcl_Obj** objPtr);
+    int read (Tcl_Interp* interp, SQLDBC_Length position, int length, Tcl_Obj* obj);
 
     /**
      * Closes the LOB. No further actions can take place.
      */
     int close (Tcl_Interp* interp);
+
+    /**
+     * Closes the LOB ignoring errors.
+     */
+    void closeQuietly ()
+    {
+        stopReadAhead();
+        if (isLobOpen) {
+            pauseConnectionReads();
+            if (lob.close() == SQLDBC_OK) isLobOpen = false;
+        }
+    }
+
+    /**
+     * Reads the entire content of the LOB if its length is less than the limit. Returns NULL if
+     * the LOB is longer or if it cannot be read.
+     */
+    Tcl_Obj* readInline (SQLDBC_Length limit);
+
+    /**
+     * Creates a channel that reads from or writes into the LOB. The mode is either TCL_READABLE or TCL_WRITABLE.
+     */
+    Tcl_Channel openChannel (Tcl_Interp* interp, int mode);
+
+    /**
+     * Maximum number of chunks that are read ahead.
+     */
+    static const int MAX_READ_AHEAD_DEPTH = 2;
+
+    /**
+     * Sets the number of chunks that the read-ahead thread keeps prefetched while the script
+     * consumes the current one. Sequential reads are synchronous when the depth is 0.
+     */
+    int setReadAheadDepth (Tcl_Interp* interp, int depth);
+
+    /**
+     * Returns the number of chunks that are read ahead.
+     */
+    int getReadAheadDepth ();
+
+    /**
+     * Waits until the chunk that is being prefetched is read, and stops prefetching until the
+     * next sequential read, so the connection can be used by other requests.
+     */
+    void pauseReadAhead ();
+
+    /**
+     * Pauses read-ahead threads of all LOBs of the statement connection, as channels read and write
+     * LOBs outside of the connection commands.
+     */
+    void pauseConnectionReads ();
+
+    /**
+     * Stops the read-ahead thread and discards prefetched chunks.
+     */
+    void stopReadAhead ();
 };
 
 extern Tcl_ObjType sdbLobType;
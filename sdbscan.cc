@@ -0,0 +1,303 @@
+#include "sdbscan.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+SqlParams::~SqlParams()
+{
+    for (auto it = names.begin(); it != names.end(); ++it) {
+        if (*it) Tcl_DecrRefCount(*it);
+    }
+}
+
+/**
+ * Returns true if the character can be a part of the parameter name. Bytes of multi-byte UTF-8
+ * characters are accepted as well, so national letters can be used in names.
+ */
+static inline bool isNameChar (unsigned char c)
+{
+    return ('A' <= c && c <= 'Z') || ('a' <= c && c <= 'z') || ('0' <= c && c <= '9') || c == '_' || c >= 0x80;
+}
+
+/**
+ * Returns the position right after the closing quote of the quoted text which starts at p.
+ * Quotes inside the text are escaped by doubling them.
+ */
+static const char* skipQuoted (const char* p, const char* end)
+{
+    char quote = *p++;
+    while (p < end) {
+        if (*p++ == quote) {
+            if (p < end && *p == quote) {
+                ++p;
+            } else {
+                break;
+            }
+        }
+    }
+    return p;
+}
+
+void scanSqlParams(const char* sql, int len, SqlParams& params)
+{
+    const char* end = sql + len;
+    const char* p   = sql;
+    while (p < end) {
+        switch (*p) {
+            case '\'':
+            case '"': {
+                p = skipQuoted(p, end);
+                break;
+            }
+            case '-': {
+                if (p + 1 < end && p[1] == '-') {
+                    p += 2;
+                    while (p < end && *p != '\n') ++p;
+                } else {
+                    ++p;
+                }
+                break;
+            }
+            case '/': {
+                if (p + 1 < end && p[1] == '*') {
+                    p += 2;
+                    while (p < end && !(*p == '*' && p + 1 < end && p[1] == '/')) ++p;
+                    p = p < end ? p + 2 : end;
+                } else {
+                    ++p;
+                }
+                break;
+            }
+            case '?': {
+                params.names.push_back(nullptr);
+                params.hasPositional = true;
+                ++p;
+                break;
+            }
+            case ':': {
+                const char* start = p++;
+                while (p < end && isNameChar(*p)) ++p;
+                if (p - start > 1) {
+                    Tcl_Obj* name = Tcl_NewStringObj(start, p - start);
+                    Tcl_IncrRefCount(name);
+                    params.names.push_back(name);
+                    params.hasNamed = true;
+                }
+                break;
+            }
+            default: {
+                ++p;
+            }
+        }
+    }
+}
+
+static inline bool isDigit (unsigned char c)
+{
+    return '0' <= c && c <= '9';
+}
+
+/**
+ * Returns true if the word is the keyword. The keyword is expected to be in upper case.
+ */
+static bool isKeyword (const char* word, int len, const char* keyword)
+{
+    return std::strlen(keyword) == (size_t) len && strncasecmp(word, keyword, len) == 0;
+}
+
+/**
+ * Returns the position after the closing quote of the quoted text which starts at p or NULL
+ * if the quoted text is not terminated.
+ */
+static const char* findQuotedEnd (const char* p, const char* end)
+{
+    char quote = *p++;
+    while (p < end) {
+        if (*p++ == quote) {
+            if (p < end && *p == quote) {
+                ++p;
+            } else {
+                return p;
+            }
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Replaces the literal that spans from start to stop with the parameter marker.
+ */
+static void liftLiteral (std::string& text, const char*& copied, const char* start, const char* stop, Tcl_Obj* value, std::vector<Tcl_Obj*>& args)
+{
+    text.append(copied, start - copied);
+    text.push_back('?');
+    copied = stop;
+    Tcl_IncrRefCount(value);
+    args.push_back(value);
+}
+
+static void releaseArgs (std::vector<Tcl_Obj*>& args, size_t size)
+{
+    for (size_t i = size; i < args.size(); i++) {
+        Tcl_DecrRefCount(args[i]);
+    }
+    args.resize(size);
+}
+
+bool liftSqlLiterals(const char* sql, int len, std::string& text, std::vector<Tcl_Obj*>& args)
+{
+    const char* end    = sql + len;
+    const char* p      = sql;
+    const char* copied = sql;  // SQL before this position has been appended to the text
+
+    bool        isFirstWord  = true;
+    bool        inOrderBy    = false;  // numbers in ORDER BY and GROUP BY are column positions
+    bool        expectInList = false;
+    const char* prevWord     = nullptr;
+    int         prevWordLen  = 0;
+    int         depth        = 0;
+
+    // IN list which literals are being lifted
+    int         listDepth = -1;
+    const char* listStart = nullptr;
+    size_t      listText  = 0;
+    size_t      listArgs  = 0;
+
+    text.clear();
+    while (p < end) {
+        unsigned char c = *p;
+        if (c == '\'') {
+            const char* start = p;
+            if ((p = findQuotedEnd(p, end)) == nullptr) {
+                goto NotLifted;
+            }
+            // empty strings are left in the SQL as empty arguments are bound as NULL
+            if (p - start > 2) {
+                std::string value;
+                for (const char* q = start + 1; q < p - 1; q++) {
+                    value.push_back(*q);
+                    if (*q == '\'') ++q;  // '' is an escaped quote
+                }
+                liftLiteral(text, copied, start, p, Tcl_NewStringObj(value.data(), value.size()), args);
+            }
+        } else if (c == '"') {
+            if ((p = findQuotedEnd(p, end)) == nullptr) {
+                goto NotLifted;
+            }
+        } else if (c == '-' && p + 1 < end && p[1] == '-') {
+            while (p < end && *p != '\n') ++p;
+        } else if (c == '/' && p + 1 < end && p[1] == '*') {
+            p += 2;
+            while (p < end && !(*p == '*' && p + 1 < end && p[1] == '/')) ++p;
+            p = p < end ? p + 2 : end;
+        } else if (c == '?' || c == ':' || c == '{') {
+            // parameterized SQL and ODBC escape sequences are left as they are
+            goto NotLifted;
+        } else if (isNameChar(c) && !isDigit(c)) {
+            const char* word = p;
+            while (p < end && isNameChar(*p)) ++p;
+            int wordLen = p - word;
+            if (isFirstWord) {
+                if (!isKeyword(word, wordLen, "SELECT") && !isKeyword(word, wordLen, "INSERT") && !isKeyword(word, wordLen, "UPDATE") && !isKeyword(word, wordLen, "DELETE")) {
+                    goto NotLifted;
+                }
+                isFirstWord = false;
+            }
+            if (p < end && *p == '\'') {
+                // typed literals, like X'0A0D', are left as they are
+                if ((p = findQuotedEnd(p, end)) == nullptr) {
+                    goto NotLifted;
+                }
+            } else if (isKeyword(word, wordLen, "BY") && prevWord && (isKeyword(prevWord, prevWordLen, "ORDER") || isKeyword(prevWord, prevWordLen, "GROUP"))) {
+                inOrderBy = true;
+            } else if (isKeyword(word, wordLen, "HAVING") || isKeyword(word, wordLen, "UNION") || isKeyword(word, wordLen, "EXCEPT") || isKeyword(word, wordLen, "INTERSECT") || isKeyword(word, wordLen, "FOR")) {
+                inOrderBy = false;
+            }
+            expectInList = isKeyword(word, wordLen, "IN");
+            prevWord     = word;
+            prevWordLen  = wordLen;
+        } else if (isDigit(c) || (c == '.' && p + 1 < end && isDigit(p[1]))) {
+            const char* start     = p;
+            bool        isInteger = true;
+            while (p < end && isDigit(*p)) ++p;
+            if (p < end && *p == '.') {
+                isInteger = false;
+                while (++p < end && isDigit(*p));
+            }
+            if (p < end && (*p == 'E' || *p == 'e')) {
+                isInteger = false;
+                if (++p < end && (*p == '+' || *p == '-')) ++p;
+                while (p < end && isDigit(*p)) ++p;
+            }
+            if (p < end && isNameChar(*p)) {
+                // not a number
+                while (p < end && isNameChar(*p)) ++p;
+                isInteger = false;
+            }
+            // decimals and zero-padded numbers are left in the SQL as their parameters might expect an integer or a text
+            if (isInteger && !inOrderBy && (*start != '0' || p - start == 1)) {
+                errno = 0;
+                Tcl_WideInt value = std::strtoll(start, nullptr, 10);
+                if (errno != ERANGE) {
+                    liftLiteral(text, copied, start, p, Tcl_NewWideIntObj(value), args);
+                }
+            }
+            expectInList = false;
+        } else if (c == '(') {
+            ++depth;
+            if (expectInList && listDepth < 0) {
+                text.append(copied, p - copied);
+                copied    = p;
+                listDepth = depth;
+                listStart = p;
+                listText  = text.size();
+                listArgs  = args.size();
+            }
+            expectInList = false;
+            ++p;
+        } else if (c == ')') {
+            if (depth == listDepth) {
+                if (args.size() - listArgs > MAX_LIFTED_IN_LIST) {
+                    text.resize(listText);
+                    releaseArgs(args, listArgs);
+                    copied = listStart;
+                }
+                listDepth = -1;
+            }
+            --depth;
+            inOrderBy = false;
+            ++p;
+        } else {
+            if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+                expectInList = false;
+            }
+            ++p;
+        }
+    }
+    if (args.empty()) {
+        goto NotLifted;
+    }
+    text.append(copied, end - copied);
+    return true;
+
+NotLifted:
+    text.clear();
+    releaseArgs(args, 0);
+    return false;
+}
+
+const SqlParams& SqlScanCache::scan(const char* sql, int len)
+{
+    std::string key(sql, len);
+
+    auto found = scans.find(key);
+    if (found != scans.end()) {
+        return found->second;
+    }
+    if (scans.size() >= MAX_SIZE) {
+        scans.clear();
+    }
+    SqlParams& params = scans[key];
+    scanSqlParams(sql, len, params);
+    return params;
+}
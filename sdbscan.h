@@ -0,0 +1,62 @@
+#pragma once
+
+#include "sdbtcl.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Parameter markers of the SQL statement.
+ */
+struct SqlParams {
+    std::vector<Tcl_Obj*> names;          /// :NAME of each marker in the order of their appearance or NULL for ?
+    bool                  hasPositional;
+    bool                  hasNamed;
+
+    SqlParams() : hasPositional(false), hasNamed(false) {}
+    ~SqlParams();
+
+    SqlParams(const SqlParams&) = delete;
+    SqlParams& operator= (const SqlParams&) = delete;
+};
+
+/**
+ * Finds parameter markers in the SQL text.
+ *
+ * Markers are recognized only outside of string literals, quoted identifiers and comments.
+ */
+void scanSqlParams (const char* sql, int len, SqlParams& params);
+
+/**
+ * Maximum number of literals in an IN list that are lifted into parameters. Literals of longer
+ * lists are left in the SQL text, as each length of the list would be a distinct statement anyway.
+ */
+const int MAX_LIFTED_IN_LIST = 32;
+
+/**
+ * Replaces string and integer literals of the DML statement with positional parameter markers.
+ * The parameterized SQL is stored in the text and the literal values are appended to the args.
+ * Returned args are preserved and must be released by the caller.
+ *
+ * Returns false, leaving the text and args empty, if the SQL is not a DML statement, if it
+ * already has parameters, or if it does not have literals that could be lifted.
+ */
+bool liftSqlLiterals (const char* sql, int len, std::string& text, std::vector<Tcl_Obj*>& args);
+
+/**
+ * Cache of scanned SQL texts, so statements that are prepared again do not need to be rescanned.
+ */
+class SqlScanCache {
+    std::unordered_map<std::string, SqlParams> scans;
+
+public:
+    /**
+     * Maximum number of cached scans. When it is reached the cache is reset.
+     */
+    static const size_t MAX_SIZE = 256;
+
+    /**
+     * Returns parameter markers of the SQL. The result remains valid until the next call.
+     */
+    const SqlParams& scan (const char* sql, int len);
+};
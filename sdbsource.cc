@@ -0,0 +1,250 @@
+#include "sdbsource.h"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Content of an empty file, which is not mapped.
+ */
+static const char emptyContent[1] = "";
+
+SdbLobSource::~SdbLobSource()
+{
+    if (data != nullptr && data != emptyContent) {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+        CloseHandle(mapping);
+#else
+        munmap((void*) data, size);
+#endif
+    }
+    if (chan != nullptr) {
+        if (isModeSaved) {
+            // binary translation also changes the encoding and the end-of-file character
+            Tcl_SetChannelOption(nullptr, chan, "-translation", translation.c_str());
+            Tcl_SetChannelOption(nullptr, chan, "-encoding", encoding.c_str());
+            Tcl_SetChannelOption(nullptr, chan, "-eofchar", eofChar.c_str());
+        }
+        Tcl_UnregisterChannel(nullptr, chan);
+    }
+}
+
+SdbLobSource* SdbLobSource::mapFile(Tcl_Interp* interp, Tcl_Obj* path)
+{
+    const void* nativePath = Tcl_FSGetNativePath(path);
+    if (nativePath == nullptr) {
+        Tcl_AppendResult(interp, "invalid file name \"", Tcl_GetString(path), "\"", nullptr);
+        return nullptr;
+    }
+    SdbLobSource* source = new SdbLobSource();
+#ifdef _WIN32
+    HANDLE file = CreateFileW((const WCHAR*) nativePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        Tcl_AppendResult(interp, "cannot open file \"", Tcl_GetString(path), "\"", nullptr);
+        delete source;
+        return nullptr;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        Tcl_AppendResult(interp, "cannot get the size of file \"", Tcl_GetString(path), "\"", nullptr);
+        CloseHandle(file);
+        delete source;
+        return nullptr;
+    }
+    source->size = (size_t) fileSize.QuadPart;
+    if (source->size > 0) {
+        source->mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (source->mapping != nullptr) {
+            source->data = (const char*) MapViewOfFile(source->mapping, FILE_MAP_READ, 0, 0, 0);
+            if (source->data == nullptr) {
+                CloseHandle(source->mapping);
+            }
+        }
+    } else {
+        source->data = emptyContent;
+    }
+    CloseHandle(file);
+    if (source->data == nullptr) {
+        Tcl_AppendResult(interp, "cannot map file \"", Tcl_GetString(path), "\" into memory", nullptr);
+        delete source;
+        return nullptr;
+    }
+#else
+    int fd = ::open((const char*) nativePath, O_RDONLY);
+    if (fd < 0) {
+        Tcl_AppendResult(interp, "cannot open file \"", Tcl_GetString(path), "\": ", Tcl_PosixError(interp), nullptr);
+        delete source;
+        return nullptr;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        Tcl_AppendResult(interp, "cannot get the size of file \"", Tcl_GetString(path), "\": ", Tcl_PosixError(interp), nullptr);
+        ::close(fd);
+        delete source;
+        return nullptr;
+    }
+    source->size = (size_t) info.st_size;
+    if (source->size > 0) {
+        void* addr = mmap(nullptr, source->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            Tcl_AppendResult(interp, "cannot map file \"", Tcl_GetString(path), "\" into memory: ", Tcl_PosixError(interp), nullptr);
+            ::close(fd);
+            delete source;
+            return nullptr;
+        }
+        // the content is read once from start to end
+        madvise(addr, source->size, MADV_SEQUENTIAL);
+        source->data = (const char*) addr;
+    } else {
+        source->data = emptyContent;
+    }
+    ::close(fd);
+#endif
+    return source;
+}
+
+SdbLobSource* SdbLobSource::readChannel(Tcl_Interp* interp, Tcl_Obj* name)
+{
+    int         mode;
+    Tcl_Channel chan = Tcl_GetChannel(interp, Tcl_GetString(name), &mode);
+    if (chan == nullptr) {
+        return nullptr;
+    }
+    if ((mode & TCL_READABLE) == 0) {
+        Tcl_AppendResult(interp, "channel \"", Tcl_GetString(name), "\" wasn't opened for reading", nullptr);
+        return nullptr;
+    }
+    SdbLobSource* source = new SdbLobSource();
+    // keep the channel open until the source is released
+    Tcl_RegisterChannel(nullptr, chan);
+    source->chan = chan;
+    return source;
+}
+
+int SdbLobSource::putInto(Tcl_Interp* interp, SQLDBC_PreparedStatement* stmt, SQLDBC_HostType hostType)
+{
+    return chan ? putChannel(interp, stmt, hostType) : putMapped(interp, stmt, hostType);
+}
+
+int SdbLobSource::putMapped(Tcl_Interp* interp, SQLDBC_PreparedStatement* stmt, SQLDBC_HostType hostType)
+{
+    size_t offset = 0;
+    do {
+        size_t length = size - offset;
+        if (length > CHUNK_SIZE) {
+            length = CHUNK_SIZE;
+        }
+        if (hostType != SQLDBC_HOSTTYPE_BINARY && offset + length < size) {
+            // do not split UTF-8 sequences between chunks
+            size_t end = offset + length;
+            while (end > offset + length - TCL_UTF_MAX && (data[end] & 0xC0) == 0x80) --end;
+            length = end - offset;
+        }
+        SQLDBC_Length lengthIndicator = length;
+        if (stmt->putData((void*) (data + offset), &lengthIndicator) != SQLDBC_OK) {
+            setTclError(interp, stmt->error());
+            return TCL_ERROR;
+        }
+        offset += length;
+    } while (offset < size);
+    return TCL_OK;
+}
+
+int SdbLobSource::setBinaryMode(Tcl_Interp* interp)
+{
+    if (isModeSaved) {
+        // the source was already sent, and the channel is still in binary mode
+        return TCL_OK;
+    }
+    const char*  options[] = {"-translation", "-encoding", "-eofchar"};
+    std::string* saved[]   = {&translation, &encoding, &eofChar};
+    for (int i = 0; i < 3; i++) {
+        Tcl_DString value;
+        Tcl_DStringInit(&value);
+        if (Tcl_GetChannelOption(interp, chan, options[i], &value) != TCL_OK) {
+            Tcl_DStringFree(&value);
+            return TCL_ERROR;
+        }
+        saved[i]->assign(Tcl_DStringValue(&value), Tcl_DStringLength(&value));
+        Tcl_DStringFree(&value);
+    }
+    if (Tcl_SetChannelOption(interp, chan, "-translation", "binary") != TCL_OK) {
+        return TCL_ERROR;
+    }
+    isModeSaved = true;
+    return TCL_OK;
+}
+
+int SdbLobSource::putChannel(Tcl_Interp* interp, SQLDBC_PreparedStatement* stmt, SQLDBC_HostType hostType)
+{
+    // bytes of binary values are sent as they are, without end-of-line translation and decoding
+    if (hostType == SQLDBC_HOSTTYPE_BINARY && setBinaryMode(interp) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    Tcl_Obj* chunk = Tcl_NewObj();
+    Tcl_IncrRefCount(chunk);
+    int rc = TCL_OK;
+    do {
+        if (Tcl_ReadChars(chan, chunk, CHUNK_SIZE, 0) < 0) {
+            if (Tcl_InputBlocked(chan)) {
+                TclSetResult(interp, "cannot read LOB data from a non-blocking channel", TCL_STATIC);
+            } else {
+                Tcl_AppendResult(interp, "error reading channel: ", Tcl_PosixError(interp), nullptr);
+            }
+            rc = TCL_ERROR;
+            break;
+        }
+        int         length;
+        const char* bytes;
+        if (hostType == SQLDBC_HOSTTYPE_BINARY) {
+            bytes = (const char*) Tcl_GetByteArrayFromObj(chunk, &length);
+        } else {
+            bytes = Tcl_GetStringFromObj(chunk, &length);
+        }
+        SQLDBC_Length lengthIndicator = length;
+        if (stmt->putData((void*) bytes, &lengthIndicator) != SQLDBC_OK) {
+            setTclError(interp, stmt->error());
+            rc = TCL_ERROR;
+            break;
+        }
+    } while (!Tcl_Eof(chan));
+    Tcl_DecrRefCount(chunk);
+    return rc;
+}
+
+// ------------------------------------------------------------------------------------------------
+
+static void freeIntRep (Tcl_Obj* obj)
+{
+    SdbLobSource* source = (SdbLobSource*) obj->internalRep.otherValuePtr;
+    source->release();
+    obj->internalRep.otherValuePtr = nullptr;
+}
+
+static void dupIntRep (Tcl_Obj* src, Tcl_Obj* dst)
+{
+    SdbLobSource* source = (SdbLobSource*) (dst->internalRep.otherValuePtr = src->internalRep.otherValuePtr);
+    if (source) {
+        source->preserve();
+    }
+    dst->typePtr = &sdbLobSourceType;
+}
+
+Tcl_ObjType sdbLobSourceType = {
+    .name           = (char*) "sdblobsource",
+    .freeIntRepProc = freeIntRep,
+    .dupIntRepProc  = dupIntRep,
+};
+
+Tcl_Obj* Tcl_NewSdbLobSourceObj (SdbLobSource* source)
+{
+    Tcl_Obj* obj = Tcl_NewObj();
+    obj->typePtr = &sdbLobSourceType;
+
+    obj->internalRep.otherValuePtr = source;
+    source->preserve();
+    return obj;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "sdbtcl.h"
+#include <string>
+
+/**
+ * Content of a file or a channel that is streamed into a LONG parameter when the statement is
+ * executed, so the value is never copied into TCL memory as a whole.
+ */
+class SdbLobSource {
+    const char* data;  /// mapped file content or NULL for channel sources
+    size_t      size;
+    Tcl_Channel chan;
+    int         refCount;
+    bool        isModeSaved;  /// the channel was switched into binary mode and its original options were saved
+    std::string translation;  /// original channel options, which are restored when the source is released
+    std::string encoding;
+    std::string eofChar;
+#ifdef _WIN32
+    HANDLE mapping;
+#endif
+
+    SdbLobSource() : data(nullptr), size(0), chan(nullptr), refCount(0), isModeSaved(false) {}
+
+    /**
+     * Saves the channel options that the binary mode changes and switches the channel into it.
+     */
+    int setBinaryMode (Tcl_Interp* interp);
+
+    /**
+     * Sends the mapped file content in chunks.
+     */
+    int putMapped (Tcl_Interp* interp, SQLDBC_PreparedStatement* stmt, SQLDBC_HostType hostType);
+
+    /**
+     * Reads the channel, until it is exhausted, and sends what was read in chunks.
+     */
+    int putChannel (Tcl_Interp* interp, SQLDBC_PreparedStatement* stmt, SQLDBC_HostType hostType);
+
+public:
+    ~SdbLobSource();
+
+    SdbLobSource& operator= (const SdbLobSource&) = delete;
+
+    /**
+     * Maximum number of bytes (characters for channels in text mode) that are sent to the server
+     * with a single `putData`.
+     */
+    static const size_t CHUNK_SIZE = 32768;
+
+    /**
+     * Maps the content of the file into memory. Returns NULL, and sets TCL error, if the file
+     * cannot be mapped.
+     */
+    static SdbLobSource* mapFile (Tcl_Interp* interp, Tcl_Obj* path);
+
+    /**
+     * Creates a source that reads the channel. Returns NULL, and sets TCL error, if the channel
+     * does not exist or if it is not readable.
+     */
+    static SdbLobSource* readChannel (Tcl_Interp* interp, Tcl_Obj* name);
+
+    void preserve () { ++refCount; }
+    void release ()
+    {
+        if (--refCount <= 0) {
+            delete this;
+        }
+    }
+
+    /**
+     * Returns the length indicator of the parameter that is bound to this source.
+     */
+    SQLDBC_Length getLengthIndicator () { return chan ? SQLDBC_DATA_AT_EXEC : SQLDBC_LEN_DATA_AT_EXEC((SQLDBC_Length) size); }
+
+    /**
+     * Sends the content to the parameter, which data the statement needs to continue execution.
+     */
+    int putInto (Tcl_Interp* interp, SQLDBC_PreparedStatement* stmt, SQLDBC_HostType hostType);
+};
+
+extern Tcl_ObjType sdbLobSourceType;
+
+/**
+ * Creates new Tcl object that points to the LOB source.
+ */
+Tcl_Obj* Tcl_NewSdbLobSourceObj (SdbLobSource* source);
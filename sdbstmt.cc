@@ -1,8 +1,14 @@
 #include "sdbconn.h"
 #include "sdbstmt.h"
 #include "sdblob.h"
+#include "sdbcell.h"
 #include <memory>
 #include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <climits>
 
 static const NamedValue RESULT_SET_TYPES[] = {
     {"FORWARD ONLY",       12, SQLDBC_Statement::ResultSetType::FORWARD_ONLY      },
@@ -16,12 +22,58 @@ static const NamedValue RESULT_SET_CONCURRENCY_TYPES[] = {
     {"UPDATABLE LOCK OPTIMISTIC", 25, SQLDBC_Statement::ConcurrencyType::CONCUR_UPDATABLE_LOCK_OPTIMISTIC}
 };
 
-static const char* CURSOR_OPTIONS[] = {"-concurrencytype", "-cursor", "-fetchsize", "-maxrows", "-resultsettype", NULL};
-enum CursorOptions { CONCURRENCYTYPE, CURSOR, FETCHSIZE, MAXROWS, RESULTSETTYPE };
+static const char* CURSOR_OPTIONS[] = {"-concurrencytype", "-cursor", "-datetime", "-decimal", "-fetchsize", "-intern", "-lazy", "-lobinline", "-maxrows", "-resultsettype", NULL};
+enum CursorOptions { CONCURRENCYTYPE, CURSOR, DATETIME, DECIMAL, FETCHSIZE, INTERN, LAZY, LOBINLINE, MAXROWS, RESULTSETTYPE };
+
+static const char* DATETIME_MODES[] = {"string", "epoch", "epochmicros", NULL};
+static const char* DECIMAL_MODES[]  = {"native", "scaled", NULL};
+
+/**
+ * Returns the host type that is used to fetch or bind DATE, TIME and TIMESTAMP values.
+ */
+static inline SQLDBC_HostType dateTimeHostType (SQLDBC_HostType odbcType, DateTimeMode dateTimeMode)
+{
+    return dateTimeMode == DateTimeAsString ? SQLDBC_HOSTTYPE_UTF8 : odbcType;
+}
+
+/**
+ * Returns true if FIXED values are fetched or bound as packed decimals.
+ */
+static inline bool isPackedDecimal (SQLDBC_SQLType sqlType, int precision, int scale, DecimalMode decimalMode)
+{
+    // values that neither INT4/INT8 nor DOUBLE can represent exactly
+    return decimalMode == DecimalAsScaled && sqlType == SQLDBC_SQLTYPE_FIXED && (scale > 0 || precision > 15);
+}
+
+/**
+ * Returns the value that the column's length indicator should have before the column value is fetched.
+ */
+static inline SQLDBC_Length initialLength (const Column& col)
+{
+    // format of the packed decimal is passed to SQLDBC via length indicator
+    return col.hostType == SQLDBC_HOSTTYPE_DECIMAL ? SQLDBC_LEN_DECIMAL(col.precision, col.scale) : 0;
+}
+
+/**
+ * Checks whether the fetched value was longer than the column buffer. Only character and binary
+ * values can be truncated - lengths of LOBs and packed decimals do not describe the buffer content.
+ */
+static inline bool isTruncated (const Column& col, SQLDBC_Length len)
+{
+    return len > col.valueSize && (col.hostType == SQLDBC_HOSTTYPE_UTF8 || col.hostType == SQLDBC_HOSTTYPE_BINARY);
+}
+
+/**
+ * Returns the number of epoch units in one second.
+ */
+static inline Tcl_WideInt epochUnitsPerSecond (DateTimeMode dateTimeMode)
+{
+    return dateTimeMode == DateTimeAsEpochMicros ? 1000000 : 1;
+}
 
 // ------------------------------------------------------------------------------------------------
 
-Column::Column(SQLDBC_ResultSetMetaData* info, int columnNo)
+Column::Column(SQLDBC_ResultSetMetaData* info, int columnNo, DateTimeMode dateTimeMode, DecimalMode decimalMode)
 {
     char          buffer[100];
     SQLDBC_Length strLen;
@@ -41,7 +93,9 @@ Column::Column(SQLDBC_ResultSetMetaData* info, int columnNo)
         case SQLDBC_SQLTYPE_FIXED:
         case SQLDBC_SQLTYPE_FLOAT:
         case SQLDBC_SQLTYPE_VFLOAT:
-            if (precision > 15)
+            if (isPackedDecimal(sqlType, precision, scale, decimalMode))
+                hostType = SQLDBC_HOSTTYPE_DECIMAL;
+            else if (precision > 15)
                 hostType = SQLDBC_HOSTTYPE_UTF8;
             else if (scale > 0)
                 hostType = SQLDBC_HOSTTYPE_DOUBLE;
@@ -52,18 +106,196 @@ Column::Column(SQLDBC_ResultSetMetaData* info, int columnNo)
             break;
         case SQLDBC_SQLTYPE_BOOLEAN:
         case SQLDBC_SQLTYPE_SMALLINT:
-        case SQLDBC_SQLTYPE_INTEGER:  hostType = SQLDBC_HOSTTYPE_INT4; break;
+        case SQLDBC_SQLTYPE_INTEGER:   hostType = SQLDBC_HOSTTYPE_INT4; break;
         case SQLDBC_SQLTYPE_CHB:
-        case SQLDBC_SQLTYPE_VARCHARB: hostType = SQLDBC_HOSTTYPE_BINARY; break;
+        case SQLDBC_SQLTYPE_VARCHARB:  hostType = SQLDBC_HOSTTYPE_BINARY; break;
         case SQLDBC_SQLTYPE_STRB:
-        case SQLDBC_SQLTYPE_LONGB:    hostType = SQLDBC_HOSTTYPE_BLOB; break;
+        case SQLDBC_SQLTYPE_LONGB:     hostType = SQLDBC_HOSTTYPE_BLOB; break;
         case SQLDBC_SQLTYPE_STRA:
         case SQLDBC_SQLTYPE_STRE:
         case SQLDBC_SQLTYPE_STRUNI:
         case SQLDBC_SQLTYPE_LONGA:
         case SQLDBC_SQLTYPE_LONGE:
-        case SQLDBC_SQLTYPE_LONGUNI:  hostType = SQLDBC_HOSTTYPE_UTF8_CLOB; break;
-        default:                      hostType = SQLDBC_HOSTTYPE_UTF8; break;
+        case SQLDBC_SQLTYPE_LONGUNI:   hostType = SQLDBC_HOSTTYPE_UTF8_CLOB; break;
+        case SQLDBC_SQLTYPE_DATE:      hostType = dateTimeHostType(SQLDBC_HOSTTYPE_ODBCDATE, dateTimeMode); break;
+        case SQLDBC_SQLTYPE_TIME:      hostType = dateTimeHostType(SQLDBC_HOSTTYPE_ODBCTIME, dateTimeMode); break;
+        case SQLDBC_SQLTYPE_TIMESTAMP: hostType = dateTimeHostType(SQLDBC_HOSTTYPE_ODBCTIMESTAMP, dateTimeMode); break;
+        default:                       hostType = SQLDBC_HOSTTYPE_UTF8; break;
+    }
+    switch (hostType) {
+        case SQLDBC_HOSTTYPE_ODBCDATE:      valueSize = sizeof(SQL_DATE_STRUCT); break;
+        case SQLDBC_HOSTTYPE_ODBCTIME:      valueSize = sizeof(SQL_TIME_STRUCT); break;
+        case SQLDBC_HOSTTYPE_ODBCTIMESTAMP: valueSize = sizeof(SQL_TIMESTAMP_STRUCT); break;
+        case SQLDBC_HOSTTYPE_DECIMAL:       valueSize = decimalSize(precision); break;
+        case SQLDBC_HOSTTYPE_INT4:          valueSize = sizeof(int); break;
+        case SQLDBC_HOSTTYPE_INT8:          valueSize = sizeof(Tcl_WideInt); break;
+        case SQLDBC_HOSTTYPE_DOUBLE:        valueSize = sizeof(double); break;
+        case SQLDBC_HOSTTYPE_BINARY:        valueSize = byteLength; break;
+        case SQLDBC_HOSTTYPE_BLOB:
+        case SQLDBC_HOSTTYPE_UTF8_CLOB:     valueSize = sizeof(SQLDBC_LOB); break;
+        default:
+            if (sqlType == SQLDBC_SQLTYPE_FIXED || sqlType == SQLDBC_SQLTYPE_FLOAT || sqlType == SQLDBC_SQLTYPE_VFLOAT) {
+                // text representation of a number also needs space for the sign, decimal point and exponent
+                valueSize = precision + 8;
+            } else {
+                valueSize = length * TCL_UTF_MAX;
+            }
+    }
+    offset   = 0;
+    decode   = nullptr;
+    interned = nullptr;
+}
+
+InternTable::~InternTable()
+{
+    for (auto it = values.begin(); it != values.end(); ++it) {
+        Tcl_DecrRefCount(it->second);
+    }
+}
+
+Tcl_Obj* InternTable::get(const char* str, SQLDBC_Length len)
+{
+    auto it = values.find(std::string_view(str, len));
+    if (it != values.end()) {
+        return it->second;
+    }
+    Tcl_Obj* value = Tcl_NewStringObj(str, len);
+    if (values.size() < MAX_SIZE) {
+        // The key references the string representation of the interned object. It stays valid
+        // because the table's reference keeps the object shared, and thus unmodifiable.
+        Tcl_IncrRefCount(value);
+        values.emplace(std::string_view(value->bytes, value->length), value);
+    }
+    return value;
+}
+
+/**
+ * Returns the size of the column value buffer rounded up to keep buffers of the following columns aligned.
+ */
+static inline size_t alignedValueSize (SQLDBC_Length valueSize)
+{
+    return (valueSize + 7) & ~(size_t) 7;
+}
+
+template <SQLDBC_HostType hostType>
+static Tcl_Obj* decodeValue (SdbStmt& stmt, const Column& col, void* data, SQLDBC_Length len);
+
+template <>
+Tcl_Obj* decodeValue<SQLDBC_HOSTTYPE_INT4>(SdbStmt& stmt, const Column& col, void* data, SQLDBC_Length len)
+{
+    return Tcl_NewIntObj(*(int*) data);
+}
+
+template <>
+Tcl_Obj* decodeValue<SQLDBC_HOSTTYPE_INT8>(SdbStmt& stmt, const Column& col, void* data, SQLDBC_Length len)
+{
+    return Tcl_NewWideIntObj(*(Tcl_WideInt*) data);
+}
+
+template <>
+Tcl_Obj* decodeValue<SQLDBC_HOSTTYPE_DOUBLE>(SdbStmt& stmt, const Column& col, void* data, SQLDBC_Length len)
+{
+    return Tcl_NewDoubleObj(*(double*) data);
+}
+
+template <>
+Tcl_Obj* decodeValue<SQLDBC_HOSTTYPE_DECIMAL>(SdbStmt& stmt, const Column& col, void* data, SQLDBC_Length len)
+{
+    return newDecimalObj((unsigned char*) data, col.precision);
+}
+
+template <>
+Tcl_Obj* decodeValue<SQLDBC_HOSTTYPE_BINARY>(SdbStmt& stmt, const Column& col, void* data, SQLDBC_Length len)
+{
+    return Tcl_NewByteArrayObj((unsigned char*) data, len);
+}
+
+template <>
+Tcl_Obj* decodeValue<SQLDBC_HOSTTYPE_UTF8>(SdbStmt& stmt, const Column& col, void* data, SQLDBC_Length len)
+{
+    return Tcl_NewStringObj((char*) data, len);
+}
+
+template <>
+Tcl_Obj* decodeValue<SQLDBC_HOSTTYPE_BLOB>(SdbStmt& stmt, const Column& col, void* data, SQLDBC_Length len)
+{
+    return Tcl_NewSdbLobObj(new SdbLob(*(SQLDBC_LOB*) data, SQLDBC_HOSTTYPE_BLOB, stmt));
+}
+
+template <>
+Tcl_Obj* decodeValue<SQLDBC_HOSTTYPE_UTF8_CLOB>(SdbStmt& stmt, const Column& col, void* data, SQLDBC_Length len)
+{
+    return Tcl_NewSdbLobObj(new SdbLob(*(SQLDBC_LOB*) data, SQLDBC_HOSTTYPE_UTF8_CLOB, stmt));
+}
+
+/**
+ * Returns the content of the LOB that is shorter than the statement's inline size, or the LOB
+ * handle for the longer ones.
+ */
+template <SQLDBC_HostType hostType>
+static Tcl_Obj* decodeInlineLob (SdbStmt& stmt, const Column& col, void* data, SQLDBC_Length len)
+{
+    SdbLob* lob = new SdbLob(*(SQLDBC_LOB*) data, hostType, stmt);
+    lob->preserve();
+
+    Tcl_Obj* value = lob->readInline(stmt.getLobInlineSize());
+    if (value == nullptr) {
+        value = Tcl_NewSdbLobObj(lob);
+    } else {
+        lob->closeQuietly();
+    }
+    lob->release();
+    return value;
+}
+
+template <SQLDBC_HostType hostType, Tcl_WideInt unitsPerSecond>
+static Tcl_Obj* decodeEpoch (SdbStmt& stmt, const Column& col, void* data, SQLDBC_Length len)
+{
+    return Tcl_NewWideIntObj(dateTimeToEpoch(hostType, data, unitsPerSecond));
+}
+
+/**
+ * Returns the converter of DATE, TIME and TIMESTAMP values into epoch units.
+ */
+template <SQLDBC_HostType hostType>
+static ValueDecoder getEpochDecoder (Tcl_WideInt unitsPerSecond)
+{
+    return unitsPerSecond == 1 ? decodeEpoch<hostType, 1> : decodeEpoch<hostType, 1000000>;
+}
+
+/**
+ * Returns shared string for the repeating values of the interned column.
+ */
+static Tcl_Obj* decodeInternedValue (SdbStmt& stmt, const Column& col, void* data, SQLDBC_Length len)
+{
+    return col.interned->get((char*) data, len);
+}
+
+/**
+ * Returns the fetched packed decimal as a lazy cell that keeps a copy of its digits.
+ */
+static Tcl_Obj* decodeLazyDecimal (SdbStmt& stmt, const Column& col, void* data, SQLDBC_Length len)
+{
+    return Tcl_NewSdbCellObj(col.precision, (unsigned char*) data);
+}
+
+/**
+ * Returns the value converter for the column's host type.
+ */
+static ValueDecoder getValueDecoder (SQLDBC_HostType hostType, DateTimeMode dateTimeMode)
+{
+    switch (hostType) {
+        case SQLDBC_HOSTTYPE_ODBCDATE:      return getEpochDecoder<SQLDBC_HOSTTYPE_ODBCDATE>(epochUnitsPerSecond(dateTimeMode));
+        case SQLDBC_HOSTTYPE_ODBCTIME:      return getEpochDecoder<SQLDBC_HOSTTYPE_ODBCTIME>(epochUnitsPerSecond(dateTimeMode));
+        case SQLDBC_HOSTTYPE_ODBCTIMESTAMP: return getEpochDecoder<SQLDBC_HOSTTYPE_ODBCTIMESTAMP>(epochUnitsPerSecond(dateTimeMode));
+        case SQLDBC_HOSTTYPE_BLOB:          return decodeValue<SQLDBC_HOSTTYPE_BLOB>;
+        case SQLDBC_HOSTTYPE_UTF8_CLOB:     return decodeValue<SQLDBC_HOSTTYPE_UTF8_CLOB>;
+        case SQLDBC_HOSTTYPE_INT4:          return decodeValue<SQLDBC_HOSTTYPE_INT4>;
+        case SQLDBC_HOSTTYPE_INT8:          return decodeValue<SQLDBC_HOSTTYPE_INT8>;
+        case SQLDBC_HOSTTYPE_DOUBLE:        return decodeValue<SQLDBC_HOSTTYPE_DOUBLE>;
+        case SQLDBC_HOSTTYPE_DECIMAL:       return decodeValue<SQLDBC_HOSTTYPE_DECIMAL>;
+        case SQLDBC_HOSTTYPE_BINARY:        return decodeValue<SQLDBC_HOSTTYPE_BINARY>;
+        default:                            return decodeValue<SQLDBC_HOSTTYPE_UTF8>;
     }
 }
 
@@ -81,7 +313,12 @@ int ResultSetConfig::init(Tcl_Interp* interp, int* idxPtr, int objc, Tcl_Obj* co
         switch (option) {
             case CONCURRENCYTYPE: concurrency = val; break;
             case CURSOR:          name = val; break;
+            case DATETIME:        dateTime = val; break;
+            case DECIMAL:         decimal = val; break;
             case FETCHSIZE:       fetchSize = val; break;
+            case INTERN:          intern = val; break;
+            case LAZY:            lazy = val; break;
+            case LOBINLINE:       lobInline = val; break;
             case MAXROWS:         maxRows = val; break;
             case RESULTSETTYPE:   type = val; break;
         }
@@ -95,6 +332,7 @@ int ResultSetConfig::init(Tcl_Interp* interp, int* idxPtr, int objc, Tcl_Obj* co
 SdbStmt::SdbStmt(SdbConn* conn) : SdbStmt(conn, 0)
 {
     stmt = conn->createStatement();
+    conn->addStatement(this);
 }
 
 SdbStmt::~SdbStmt()
@@ -103,13 +341,19 @@ SdbStmt::~SdbStmt()
         conn->eraseStatement(this);
         releaseDatabaseHandles();
     }
+    if (internLabels) {
+        Tcl_DecrRefCount(internLabels);
+    }
 }
 
 void SdbStmt::releaseDatabaseHandles()
 {
     if (conn) {
         if (stmt) {
+            // the statement might be released while LOBs of the connection are read ahead
+            conn->pauseLobReads();
             if (rset) {
+                freeResultBuffers();
                 rset     = nullptr;
                 rsetInfo = nullptr;
                 cols.clear();
@@ -173,6 +417,66 @@ int SdbStmt::setFetchSize(Tcl_Interp* interp, Tcl_Obj* sizeObj)
     return TCL_OK;
 }
 
+int SdbStmt::setInternLabels(Tcl_Interp* interp, Tcl_Obj* labels)
+{
+    int numLabels;
+    if (Tcl_ListObjLength(interp, labels, &numLabels) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    if (internLabels) {
+        Tcl_DecrRefCount(internLabels);
+        internLabels = nullptr;
+    }
+    if (numLabels > 0) {
+        Tcl_IncrRefCount(internLabels = labels);
+    }
+    return TCL_OK;
+}
+
+int SdbStmt::setDateTimeMode(Tcl_Interp* interp, Tcl_Obj* modeObj)
+{
+    DateTimeMode mode;
+    if (Tcl_GetIndexFromObj(interp, modeObj, DATETIME_MODES, "datetime mode", 0, (int*) &mode) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    dateTimeMode = mode;
+    return TCL_OK;
+}
+
+int SdbStmt::setDecimalMode(Tcl_Interp* interp, Tcl_Obj* modeObj)
+{
+    DecimalMode mode;
+    if (Tcl_GetIndexFromObj(interp, modeObj, DECIMAL_MODES, "decimal mode", 0, (int*) &mode) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    decimalMode = mode;
+    return TCL_OK;
+}
+
+int SdbStmt::setLazyCells(Tcl_Interp* interp, Tcl_Obj* isLazyObj)
+{
+    int isLazy;
+    if (Tcl_GetBooleanFromObj(interp, isLazyObj, &isLazy) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    lazyCells = isLazy;
+    return TCL_OK;
+}
+
+int SdbStmt::setLobInlineSize(Tcl_Interp* interp, Tcl_Obj* sizeObj)
+{
+    Tcl_WideInt size;
+    if (Tcl_GetWideIntFromObj(interp, sizeObj, &size) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    if (size < 0 || size > INT_MAX / TCL_UTF_MAX) {
+        TclSetResult(interp, "LOB inline size is out of range", TCL_STATIC);
+        return TCL_ERROR;
+    }
+    lobInlineSize = size;
+    return TCL_OK;
+}
+
 int SdbStmt::configure(Tcl_Interp* interp, ResultSetConfig& config)
 {
     int rc = TCL_OK;
@@ -181,12 +485,22 @@ int SdbStmt::configure(Tcl_Interp* interp, ResultSetConfig& config)
     if (rc == TCL_OK && config.concurrency) rc = setResultSetConcurrencyType(interp, config.concurrency);
     if (rc == TCL_OK && config.fetchSize) rc = setFetchSize(interp, config.fetchSize);
     if (rc == TCL_OK && config.maxRows) rc = setMaxRows(interp, config.maxRows);
+    if (rc == TCL_OK && config.intern) rc = setInternLabels(interp, config.intern);
+    if (rc == TCL_OK && config.dateTime) rc = setDateTimeMode(interp, config.dateTime);
+    if (rc == TCL_OK && config.decimal) rc = setDecimalMode(interp, config.decimal);
+    if (rc == TCL_OK && config.lazy) rc = setLazyCells(interp, config.lazy);
+    if (rc == TCL_OK && config.lobInline) rc = setLobInlineSize(interp, config.lobInline);
+    if (config.hasOptions()) {
+        isConfigured = true;
+    }
     return rc;
 }
 
 void SdbStmt::clearResults()
 {
+    serialRanges.clear();
     if (rset) {
+        freeResultBuffers();
         rset->close();
         rset     = nullptr;
         rsetInfo = nullptr;
@@ -217,6 +531,26 @@ int SdbStmt::execute(Tcl_Interp* interp, int idx, int objc, Tcl_Obj* const objv[
     return setExecuteResult(interp);
 }
 
+void SdbStmt::internColumns()
+{
+    int       numLabels;
+    Tcl_Obj** labels;
+    Tcl_ListObjGetElements(nullptr, internLabels, &numLabels, &labels);
+    for (auto it = cols.begin(); it != cols.end(); ++it) {
+        if (it->hostType != SQLDBC_HOSTTYPE_UTF8) {
+            continue;
+        }
+        const char* colLabel = Tcl_GetString(it->label);
+        for (int i = 0; i < numLabels; i++) {
+            if (strcasecmp(colLabel, Tcl_GetString(labels[i])) == 0) {
+                it->interned = new InternTable();
+                it->decode   = decodeInternedValue;
+                break;
+            }
+        }
+    }
+}
+
 int SdbStmt::setExecuteResult(Tcl_Interp* interp)
 {
     int numRows;
@@ -228,8 +562,36 @@ int SdbStmt::setExecuteResult(Tcl_Interp* interp)
         rsetInfo    = rset->getResultSetMetaData();
         int numCols = rsetInfo->getColumnCount();
         cols.reserve(numCols);
+        rowSize = 0;
         for (int col = 1; col <= numCols; col++) {
-            cols.emplace_back(rsetInfo, col);
+            Column& column = cols.emplace_back(rsetInfo, col, dateTimeMode, decimalMode);
+            column.offset  = rowSize;
+            column.decode  = getValueDecoder(column.hostType, dateTimeMode);
+            if (lobInlineSize > 0 && column.hostType == SQLDBC_HOSTTYPE_BLOB) {
+                column.decode = decodeInlineLob<SQLDBC_HOSTTYPE_BLOB>;
+            } else if (lobInlineSize > 0 && column.hostType == SQLDBC_HOSTTYPE_UTF8_CLOB) {
+                column.decode = decodeInlineLob<SQLDBC_HOSTTYPE_UTF8_CLOB>;
+            }
+            rowSize += alignedValueSize(column.valueSize);
+        }
+        if (internLabels) {
+            internColumns();
+        }
+        if (lazyCells) {
+            for (auto it = cols.begin(); it != cols.end(); ++it) {
+                // Other values are converted when they are fetched. Numbers and dates become native
+                // TCL numbers that format their text only when it is used, and copying strings into
+                // a cell would cost as much as creating TCL strings.
+                if (it->hostType == SQLDBC_HOSTTYPE_DECIMAL && it->precision > 18) {
+                    it->decode = decodeLazyDecimal;
+                }
+            }
+        }
+        rowData = Tcl_AttemptAlloc(rowSize > 0 ? rowSize : 1);
+        if (rowData == nullptr) {
+            clearResults();
+            TclSetResult(interp, "cannot allocate row buffer", TCL_STATIC);
+            return TCL_ERROR;
         }
         numRows = rset->getResultCount();
     } else {
@@ -270,59 +632,79 @@ Error_Exit:
     return TCL_ERROR;
 }
 
-static Tcl_Obj* const DATA_TYPES[] = {
-    Tcl_NewStringObj("FIXED", 5),             // SQLDBC_SQLTYPE_FIXED         = 0,
-    Tcl_NewStringObj("FLOAT", 5),             // SQLDBC_SQLTYPE_FLOAT         = 1,
-    Tcl_NewStringObj("CHAR ASCII", 10),       // SQLDBC_SQLTYPE_CHA           = 2,
-    Tcl_NewStringObj("CHAR EBCDIC", 11),      // SQLDBC_SQLTYPE_CHE           = 3,
-    Tcl_NewStringObj("CHAR BYTE", 9),         // SQLDBC_SQLTYPE_CHB           = 4,
-    Tcl_NewStringObj("ROWID", 5),             // SQLDBC_SQLTYPE_ROWID         = 5,
-    Tcl_NewStringObj("CLOB ASCII", 10),       // SQLDBC_SQLTYPE_STRA          = 6,
-    Tcl_NewStringObj("LONG EBCDIC", 11),      // SQLDBC_SQLTYPE_STRE          = 7,
-    Tcl_NewStringObj("BLOB", 4),              // SQLDBC_SQLTYPE_STRB          = 8,
-    Tcl_NewStringObj("STRDB", 5),             // SQLDBC_SQLTYPE_STRDB         = 9,
-    Tcl_NewStringObj("DATE", 4),              // SQLDBC_SQLTYPE_DATE          = 10,
-    Tcl_NewStringObj("TIME", 4),              // SQLDBC_SQLTYPE_TIME          = 11,
-    Tcl_NewStringObj("VFLOAT", 6),            // SQLDBC_SQLTYPE_VFLOAT        = 12,
-    Tcl_NewStringObj("TIMESTAMP", 9),         // SQLDBC_SQLTYPE_TIMESTAMP     = 13,
-    Tcl_NewStringObj("UNKNOWN", 7),           // SQLDBC_SQLTYPE_UNKNOWN       = 14,
-    Tcl_NewStringObj("NUMBER", 6),            // SQLDBC_SQLTYPE_NUMBER        = 15,
-    Tcl_NewStringObj("NONUMBER", 8),          // SQLDBC_SQLTYPE_NONUMBER      = 16,
-    Tcl_NewStringObj("DURATION", 8),          // SQLDBC_SQLTYPE_DURATION      = 17,
-    Tcl_NewStringObj("DBYTEEBCDIC", 11),      // SQLDBC_SQLTYPE_DBYTEEBCDIC   = 18,
-    Tcl_NewStringObj("LONG ASCII", 10),       // SQLDBC_SQLTYPE_LONGA         = 19,
-    Tcl_NewStringObj("LONG EBCDIC", 11),      // SQLDBC_SQLTYPE_LONGE         = 20,
-    Tcl_NewStringObj("LONG BYTE", 9),         // SQLDBC_SQLTYPE_LONGB         = 21,
-    Tcl_NewStringObj("LONGDB", 6),            // SQLDBC_SQLTYPE_LONGDB        = 22,
-    Tcl_NewStringObj("BOOLEAN", 7),           // SQLDBC_SQLTYPE_BOOLEAN       = 23,
-    Tcl_NewStringObj("CHAR UNICODE", 12),     // SQLDBC_SQLTYPE_UNICODE       = 24,
-    Tcl_NewStringObj("DTFILLER1", 9),         // SQLDBC_SQLTYPE_DTFILLER1     = 25,
-    Tcl_NewStringObj("DTFILLER2", 9),         // SQLDBC_SQLTYPE_DTFILLER2     = 26,
-    Tcl_NewStringObj("VOID", 4),              // SQLDBC_SQLTYPE_VOID          = 27,
-    Tcl_NewStringObj("DTFILLER4", 9),         // SQLDBC_SQLTYPE_DTFILLER4     = 28,
-    Tcl_NewStringObj("SMALLINT", 8),          // SQLDBC_SQLTYPE_SMALLINT      = 29,
-    Tcl_NewStringObj("INTEGER", 7),           // SQLDBC_SQLTYPE_INTEGER       = 30,
-    Tcl_NewStringObj("VARCHAR ASCII", 13),    // SQLDBC_SQLTYPE_VARCHARA      = 31,
-    Tcl_NewStringObj("VARCHAR EBCDIC", 14),   // SQLDBC_SQLTYPE_VARCHARE      = 32,
-    Tcl_NewStringObj("VARCHAR BYTE", 12),     // SQLDBC_SQLTYPE_VARCHARB      = 33,
-    Tcl_NewStringObj("CLOB UNICODE", 12),     // SQLDBC_SQLTYPE_STRUNI        = 34,
-    Tcl_NewStringObj("LONG UNICODE", 12),     // SQLDBC_SQLTYPE_LONGUNI       = 35,
-    Tcl_NewStringObj("VARCHAR UNICODE", 15),  // SQLDBC_SQLTYPE_VARCHARUNI    = 36,
-    Tcl_NewStringObj("UDT", 3),               // SQLDBC_SQLTYPE_UDT           = 37,
-    Tcl_NewStringObj("ABAPTABHANDLE", 13),    // SQLDBC_SQLTYPE_ABAPTABHANDLE = 38,
-    Tcl_NewStringObj("DWYDE", 5)              // SQLDBC_SQLTYPE_DWYDE         = 39,
-};
+int SdbStmt::executeMany(Tcl_Interp* interp, Tcl_Obj* rows, int batchSize)
+{
+    TclSetResult(interp, "only prepared statements can be executed with multiple argument rows", TCL_STATIC);
+    return TCL_ERROR;
+}
+
+int SdbStmt::load(Tcl_Interp* interp, Tcl_Channel chan, const LoadFormat& format, int batchSize)
+{
+    TclSetResult(interp, "only prepared statements can load data", TCL_STATIC);
+    return TCL_ERROR;
+}
 
 int SdbStmt::getRowNumber()
 {
     return rset ? rset->getRowNumber() : 0;
 }
 
-int SdbStmt::serial(Tcl_Interp* interp, bool last)
+SQLDBC_Retcode SdbStmt::getSerialRange(SerialRange& range)
+{
+    SQLDBC_Length  keyLen;
+    SQLDBC_Retcode rc = stmt->getLastInsertedKey(SQLDBC_FIRST_INSERTED_SERIAL, SQLDBC_HOSTTYPE_INT8, &range.first, &keyLen, sizeof(range.first));
+    if (rc == SQLDBC_OK) {
+        rc = stmt->getLastInsertedKey(SQLDBC_LAST_INSERTED_SERIAL, SQLDBC_HOSTTYPE_INT8, &range.last, &keyLen, sizeof(range.last));
+    }
+    range.isKnown = rc == SQLDBC_OK;
+    return rc;
+}
+
+void SdbStmt::addSerialRange(Tcl_WideInt numRows)
+{
+    SerialRange range;
+    // failed retrievals are remembered too, so the keys of the other batches are not taken as all keys
+    if (getSerialRange(range) != SQLDBC_NO_DATA_FOUND) {
+        range.numRows = numRows;
+        serialRanges.push_back(range);
+    }
+}
+
+int SdbStmt::serial(Tcl_Interp* interp, SerialKey which)
 {
+    if (which == AllKeys) {
+        std::vector<SerialRange> ranges(serialRanges);
+        SerialRange              range;
+        if (ranges.empty() && getSerialRange(range) == SQLDBC_OK) {
+            range.numRows = stmt->getRowsAffected();
+            ranges.push_back(range);
+        }
+        Tcl_Obj* keys = Tcl_NewListObj(0, nullptr);
+        for (auto it = ranges.cbegin(); it != ranges.cend(); ++it) {
+            if (!it->isKnown) {
+                Tcl_DecrRefCount(keys);
+                char batchNo[24];
+                snprintf(batchNo, sizeof(batchNo), "%d", (int) (it - ranges.cbegin() + 1));
+                Tcl_AppendResult(interp, "serial keys of batch ", batchNo, " cannot be retrieved", nullptr);
+                return TCL_ERROR;
+            }
+            // keys are reported as a range, which is only meaningful when nothing was inserted in between
+            if (it->numRows >= 0 && it->last - it->first + 1 != it->numRows) {
+                Tcl_DecrRefCount(keys);
+                TclSetResult(interp, "serial keys of the inserted rows are not consecutive", TCL_STATIC);
+                return TCL_ERROR;
+            }
+            for (Tcl_WideInt key = it->first; key <= it->last; key++) {
+                Tcl_ListObjAppendElement(nullptr, keys, Tcl_NewWideIntObj(key));
+            }
+        }
+        Tcl_SetObjResult(interp, keys);
+        return TCL_OK;
+    }
+
     SQLDBC_Length  keyLen;
     Tcl_WideInt    keyVal;
-    SQLDBC_Int4    tag = last ? SQLDBC_LAST_INSERTED_SERIAL : SQLDBC_FIRST_INSERTED_SERIAL;
+    SQLDBC_Int4    tag = which == LastKey ? SQLDBC_LAST_INSERTED_SERIAL : SQLDBC_FIRST_INSERTED_SERIAL;
     SQLDBC_Retcode rc  = stmt->getLastInsertedKey(tag, SQLDBC_HOSTTYPE_INT8, &keyVal, &keyLen, sizeof(keyVal));
     if (rc == SQLDBC_NOT_OK) {
         setTclError(interp, stmt->error());
@@ -371,14 +753,8 @@ Tcl_Obj* SdbStmt::getColumnInfo(Tcl_Interp* interp, int colNo)
     *item++ = TCL_STR(label);
     Tcl_IncrRefCount(*item++ = col.label);
 
-    SQLDBC_SQLType sqlType  = col.sqlType;
-    Tcl_Obj*       typeName = DATA_TYPES[sqlType];
-    // check if this is the first run and pin the string
-    if (typeName->refCount == 0) {
-        typeName->refCount = 1;
-    }
     *item++ = TCL_STR(type);
-    Tcl_IncrRefCount(*item++ = typeName);
+    *item++ = getTclSqlTypeName(col.sqlType);
 
     *item++ = TCL_STR(length);
     *item++ = Tcl_NewIntObj(col.length);
@@ -410,6 +786,9 @@ Tcl_Obj* SdbStmt::getColumnInfo(Tcl_Interp* interp, int colNo)
 
 int SdbStmt::fetch(Tcl_Interp* interp, SeekType seek, int row)
 {
+    if (rowSetSize > 0) {
+        unbindRowSet();
+    }
     SQLDBC_Retcode rc;
     switch (seek) {
         case Next:     rc = rset->next(); break;
@@ -445,25 +824,21 @@ int SdbStmt::getRowData(Tcl_Interp* interp, Tcl_Obj* rowVar, Tcl_Obj* nullVar, b
     Tcl_Obj** dataItem = data;
     Tcl_Obj** nullItem = nulls;
 
-    Tcl_Obj* tclTrue  = (nullVar ? Tcl_NewBooleanObj(1) : nullptr);
-    Tcl_Obj* tclFalse = (nullVar ? Tcl_NewBooleanObj(0) : nullptr);
-    Tcl_Obj* tclNull  = Tcl_NewObj();
+    Tcl_Obj* tclTrue  = TCL_VAL(trueValue);
+    Tcl_Obj* tclFalse = TCL_VAL(falseValue);
+    Tcl_Obj* tclNull  = TCL_VAL(nullValue);
 
+    int rc    = TCL_OK;
     int colNo = 1;
     for (auto it = cols.cbegin(); it != cols.cend(); ++it, ++colNo) {
-        union {
-            double        d;
-            Tcl_WideInt   w;
-            int           i;
-            char          c[TCL_UTF_MAX * 4000];
-            unsigned char b[8000];
-            SQLDBC_LOB    h;
-        } val;
-        SQLDBC_Length  len;
-        SQLDBC_Retcode rc = rset->getObject(colNo, it->hostType, &val, &len, sizeof(val), false);
-        if (rc == SQLDBC_NOT_OK) {
+        // the row buffer was laid out when the result set was obtained, thus each column gets its own
+        // (aligned) slot that fits the column's longest value
+        void*          val = rowData + it->offset;
+        SQLDBC_Length  len = initialLength(*it);
+        if (rset->getObject(colNo, it->hostType, val, &len, it->valueSize, false) == SQLDBC_NOT_OK) {
             setTclError(interp, rset->error());
-            goto Error_Exit;
+            rc = TCL_ERROR;
+            break;
         }
 
         Tcl_Obj* colData;
@@ -472,186 +847,635 @@ int SdbStmt::getRowData(Tcl_Interp* interp, Tcl_Obj* rowVar, Tcl_Obj* nullVar, b
         if (len == SQLDBC_NULL_DATA) {
             colData = tclNull;
             isNull  = tclTrue;
+        } else if (isTruncated(*it, len)) {
+            Tcl_AppendResult(interp, "value of ", Tcl_GetString(it->label), " does not fit into the column buffer", nullptr);
+            rc = TCL_ERROR;
+            break;
         } else {
-            switch (it->hostType) {
-                case SQLDBC_HOSTTYPE_BLOB:
-                case SQLDBC_HOSTTYPE_UTF8_CLOB: colData = Tcl_NewSdbLobObj(new SdbLob(val.h, it->hostType, *this)); break;
-                case SQLDBC_HOSTTYPE_INT4:      colData = Tcl_NewIntObj(val.i); break;
-                case SQLDBC_HOSTTYPE_INT8:      colData = Tcl_NewWideIntObj(val.w); break;
-                case SQLDBC_HOSTTYPE_DOUBLE:    colData = Tcl_NewDoubleObj(val.d); break;
-                case SQLDBC_HOSTTYPE_BINARY:    colData = Tcl_NewByteArrayObj(val.b, len); break;
-                default:                        colData = Tcl_NewStringObj(val.c, len);
-            }
-            isNull = tclFalse;
+            colData = newValueObj(*it, val, len);
+            isNull  = tclFalse;
         }
         if (returnAsArray) {
             if (Tcl_ObjSetVar2(interp, rowVar, it->label, colData, TCL_LEAVE_ERR_MSG) == NULL) {
-                return TCL_ERROR;
+                rc = TCL_ERROR;
+                break;
             }
             if (nullVar != nullptr && Tcl_ObjSetVar2(interp, nullVar, it->label, isNull, TCL_LEAVE_ERR_MSG) == NULL) {
-                return TCL_ERROR;
+                rc = TCL_ERROR;
+                break;
             }
         } else {
             Tcl_IncrRefCount(*dataItem++ = colData);
-            if (isNull) {
-                Tcl_IncrRefCount(*nullItem++ = isNull);
+            if (nullVar != nullptr) {
+                *nullItem++ = isNull;
             }
         }
     }
-    if (!returnAsArray) {
+    if (rc == TCL_OK && !returnAsArray) {
         if (Tcl_ObjSetVar2(interp, rowVar, nullptr, Tcl_NewListObj(dataItem - data, data), TCL_LEAVE_ERR_MSG) == NULL) {
-            goto Error_Exit;
-        }
-        if (nullVar != nullptr && Tcl_ObjSetVar2(interp, nullVar, nullptr, Tcl_NewListObj(nullItem - nulls, nulls), TCL_LEAVE_ERR_MSG) == NULL) {
-            goto Error_Exit;
+            rc = TCL_ERROR;
+        } else if (nullVar != nullptr && Tcl_ObjSetVar2(interp, nullVar, nullptr, Tcl_NewListObj(nullItem - nulls, nulls), TCL_LEAVE_ERR_MSG) == NULL) {
+            rc = TCL_ERROR;
         }
     }
 
-    return TCL_OK;
-
-Error_Exit:
+    // lists hold their own references to the values
     for (Tcl_Obj** objPtr = data; objPtr < dataItem; ++objPtr) {
         Tcl_DecrRefCount(*objPtr);
     }
-    for (Tcl_Obj** objPtr = nulls; objPtr < nullItem; ++objPtr) {
-        Tcl_DecrRefCount(*objPtr);
-    }
-    return TCL_ERROR;
-}
 
-// ------------------------------------------------------------------------------------------------
+    return rc;
+}
 
-Param::Param(SQLDBC_ParameterMetaData* info, int paramNo) : name(nullptr), outVarName(nullptr)
+Tcl_Obj* SdbStmt::newValueObj(const Column& col, void* data, SQLDBC_Length len)
 {
-    sqlType    = info->getParameterType(paramNo);
-    length     = info->getParameterLength(paramNo);
-    precision  = info->getPrecision(paramNo);
-    scale      = info->getScale(paramNo);
-    byteLength = info->getPhysicalLength(paramNo);
-    inOutMode  = info->getParameterMode(paramNo);
+    return col.decode(*this, col, data, len);
+}
 
-    switch (sqlType) {
-        case SQLDBC_SQLTYPE_FIXED:
-        case SQLDBC_SQLTYPE_FLOAT:
-        case SQLDBC_SQLTYPE_VFLOAT:
-            if (precision > 15)
-                hostType = SQLDBC_HOSTTYPE_UTF8;
-            else if (scale > 0)
-                hostType = SQLDBC_HOSTTYPE_DOUBLE;
-            else if (precision > 9)
-                hostType = SQLDBC_HOSTTYPE_INT8;
-            else
-                hostType = SQLDBC_HOSTTYPE_INT4;
-            break;
-        case SQLDBC_SQLTYPE_BOOLEAN:
-        case SQLDBC_SQLTYPE_SMALLINT:
-        case SQLDBC_SQLTYPE_INTEGER:  hostType = SQLDBC_HOSTTYPE_INT4; break;
-        case SQLDBC_SQLTYPE_CHB:
-        case SQLDBC_SQLTYPE_VARCHARB:
-        case SQLDBC_SQLTYPE_STRB:
-        case SQLDBC_SQLTYPE_LONGB:    hostType = SQLDBC_HOSTTYPE_BINARY; break;
-        default:                      hostType = SQLDBC_HOSTTYPE_UTF8;
+int SdbStmt::bindRowSet(Tcl_Interp* interp, SQLDBC_UInt4 numRows)
+{
+    if (rowSetSize == numRows) {
+        return TCL_OK;
+    }
+    if (rowSetSize > 0) {
+        unbindRowSet();
+    }
+    // Tcl allocates blocks of up to UINT_MAX bytes
+    if (numRows == 0 || rowSize > UINT_MAX / numRows || sizeof(SQLDBC_Length) * cols.size() > UINT_MAX / numRows) {
+        TclSetResult(interp, "row set is too large, fetch fewer rows at once", TCL_STATIC);
+        return TCL_ERROR;
     }
 
-    dataLength        = 0;
-    outData.charValue = nullptr;
+    rowSetData    = Tcl_AttemptAlloc(rowSize * numRows);
+    rowSetLengths = (SQLDBC_Length*) Tcl_AttemptAlloc(sizeof(SQLDBC_Length) * cols.size() * numRows);
+    if (rowSetData == nullptr || rowSetLengths == nullptr) {
+        freeRowSet();
+        TclSetResult(interp, "cannot allocate row set buffers", TCL_STATIC);
+        return TCL_ERROR;
+    }
+    rset->setRowSetSize(numRows);
+    rowSetSize = numRows;
+    if (bindRowSetColumns(interp) != TCL_OK) {
+        rset->clearColumns();
+        rset->setRowSetSize(1);
+        freeRowSet();
+        return TCL_ERROR;
+    }
+    return TCL_OK;
+}
 
-    if (isOut()) {
-        switch (hostType) {
-            case SQLDBC_HOSTTYPE_INT4:   byteLength = sizeof(int); break;
-            case SQLDBC_HOSTTYPE_INT8:   byteLength = sizeof(Tcl_WideInt); break;
-            case SQLDBC_HOSTTYPE_DOUBLE: byteLength = sizeof(double); break;
-            case SQLDBC_HOSTTYPE_BINARY: {
-                outData.charValue = Tcl_Alloc(byteLength);
-                break;
-            }
-            default: {
-                byteLength        = length * TCL_UTF_MAX;
-                outData.charValue = Tcl_Alloc(byteLength + 1);
-            }
+int SdbStmt::bindRowSetColumns(Tcl_Interp* interp)
+{
+    // Column-wise binding - values of each column are stored in the adjacent array elements
+    int colNo = 1;
+    for (auto it = cols.cbegin(); it != cols.cend(); ++it, ++colNo) {
+        void*          data    = rowSetData + it->offset * rowSetSize;
+        SQLDBC_Length* lengths = rowSetLengths + (colNo - 1) * rowSetSize;
+        if (rset->bindColumn(colNo, it->hostType, data, lengths, it->valueSize, false) != SQLDBC_OK) {
+            setTclError(interp, rset->error());
+            return TCL_ERROR;
         }
     }
+    return TCL_OK;
 }
 
-Param::~Param()
+void SdbStmt::unbindRowSet()
 {
-    if (name) Tcl_DecrRefCount(name);
-    if (isVarChar() && outData.charValue != nullptr) Tcl_Free(outData.charValue);
+    rset->clearColumns();
+    rset->setRowSetSize(1);
+    freeRowSet();
 }
 
-bool Param::checkAndSetNull(Tcl_Obj* arg)
+void SdbStmt::freeResultBuffers()
 {
-    if (arg->typePtr == nullptr || arg->typePtr == tclStringType) {
-        int strLen;
-        Tcl_GetStringFromObj(arg, &strLen);
-        if (strLen == 0) {
-            dataLength = SQLDBC_NULL_DATA;
-            return true;
-        }
+    freeRowSet();
+    if (rowData) {
+        Tcl_Free(rowData);
+        rowData = nullptr;
     }
-    return false;
+    rowSize = 0;
 }
 
-int Param::copyIntoOutDataBuffer(Tcl_Interp* interp, Tcl_Obj* arg, int idx)
+void SdbStmt::freeRowSet()
 {
-    if (checkAndSetNull(arg)) {
-        return TCL_OK;
+    if (rowSetData) {
+        Tcl_Free(rowSetData);
+        rowSetData = nullptr;
     }
+    if (rowSetLengths) {
+        Tcl_Free((char*) rowSetLengths);
+        rowSetLengths = nullptr;
+    }
+    rowSetSize = 0;
+}
 
-    switch (hostType) {
-        case SQLDBC_HOSTTYPE_INT4:
-            if (Tcl_GetIntFromObj(interp, arg, &outData.intValue) != TCL_OK) return TCL_ERROR;
-            dataLength = sizeof(int);
-            break;
-        case SQLDBC_HOSTTYPE_INT8:
-            if (Tcl_GetWideIntFromObj(interp, arg, &outData.wideIntValue) != TCL_OK) return TCL_ERROR;
-            dataLength = sizeof(Tcl_WideInt);
-            break;
-        case SQLDBC_HOSTTYPE_DOUBLE:
-            if (Tcl_GetDoubleFromObj(interp, arg, &outData.doubleValue) != TCL_OK) return TCL_ERROR;
-            dataLength = sizeof(double);
+int SdbStmt::fetchRowSet(Tcl_Interp* interp, SQLDBC_UInt4 numRows, int* numFetched)
+{
+    if (rset == nullptr) {
+        TclSetResult(interp, "the last executed SQL was not a query", TCL_STATIC);
+        return TCL_ERROR;
+    }
+    if (bindRowSet(interp, numRows) != TCL_OK) {
+        return TCL_ERROR;
+    }
+
+    *numFetched = 0;
+
+
+    int colIdx = 0;
+    for (auto it = cols.cbegin(); it != cols.cend(); ++it, ++colIdx) {
+        if (it->hostType == SQLDBC_HOSTTYPE_DECIMAL) {
+            SQLDBC_Length* lengths = rowSetLengths + colIdx * rowSetSize;
+            std::fill(lengths, lengths + rowSetSize, initialLength(*it));
+        }
+    }
+
+    SQLDBC_Retcode rc = rset->next();
+    if (rc == SQLDBC_OK) {
+        SQLDBC_RowSet* rowSet = rset->getRowSet();
+        rc = rowSet->fetch();
+        if (rc == SQLDBC_OK || rc == SQLDBC_DATA_TRUNC) {
+            *numFetched = rowSet->getRowsAffected();
+        }
+    }
+    if (rc == SQLDBC_NOT_OK) {
+        setTclError(interp, rset->error());
+        return TCL_ERROR;
+    }
+    return TCL_OK;
+}
+
+Tcl_Obj* SdbStmt::getRowSetValue(Tcl_Interp* interp, int colIdx, SQLDBC_UInt4 row, Tcl_Obj* nullObj)
+{
+    const Column& col = cols[colIdx];
+    SQLDBC_Length len = rowSetLengths[colIdx * rowSetSize + row];
+    if (len == SQLDBC_NULL_DATA) {
+        return nullObj;
+    }
+    if (isTruncated(col, len)) {
+        Tcl_AppendResult(interp, "value of ", Tcl_GetString(col.label), " does not fit into the column buffer", nullptr);
+        return nullptr;
+    }
+    return newValueObj(col, rowSetData + col.offset * rowSetSize + row * col.valueSize, len);
+}
+
+int SdbStmt::fetchRows(Tcl_Interp* interp, SQLDBC_UInt4 numRows, Tcl_Obj* rowsVar, Tcl_Obj* nullsVar)
+{
+    int numFetched;
+    if (fetchRowSet(interp, numRows, &numFetched) != TCL_OK) {
+        return TCL_ERROR;
+    }
+
+    Tcl_Obj* rows     = Tcl_NewListObj(0, nullptr);
+    Tcl_Obj* nulls    = (nullsVar ? Tcl_NewListObj(0, nullptr) : nullptr);
+    Tcl_Obj* tclTrue  = TCL_VAL(trueValue);
+    Tcl_Obj* tclFalse = TCL_VAL(falseValue);
+    Tcl_Obj* tclNull  = TCL_VAL(nullValue);
+
+    Tcl_IncrRefCount(rows);
+    if (nulls) Tcl_IncrRefCount(nulls);
+
+    int      numCols = cols.size();
+    Tcl_Obj* rowData[numCols];
+    Tcl_Obj* rowNulls[numCols];
+
+    int rc = TCL_OK;
+    for (int row = 0; row < numFetched && rc == TCL_OK; row++) {
+        for (int colIdx = 0; colIdx < numCols; colIdx++) {
+            Tcl_Obj* value = getRowSetValue(interp, colIdx, row, tclNull);
+            if (value == nullptr) {
+                // discard values that were created for this row so far
+                Tcl_DecrRefCount(Tcl_NewListObj(colIdx, rowData));
+                rc = TCL_ERROR;
+                break;
+            }
+            rowData[colIdx]  = value;
+            rowNulls[colIdx] = (value == tclNull ? tclTrue : tclFalse);
+        }
+        if (rc == TCL_OK) {
+            Tcl_ListObjAppendElement(nullptr, rows, Tcl_NewListObj(numCols, rowData));
+            if (nulls) {
+                Tcl_ListObjAppendElement(nullptr, nulls, Tcl_NewListObj(numCols, rowNulls));
+            }
+        }
+    }
+    if (rc == TCL_OK && Tcl_ObjSetVar2(interp, rowsVar, nullptr, rows, TCL_LEAVE_ERR_MSG) == nullptr) {
+        rc = TCL_ERROR;
+    }
+    if (rc == TCL_OK && nulls && Tcl_ObjSetVar2(interp, nullsVar, nullptr, nulls, TCL_LEAVE_ERR_MSG) == nullptr) {
+        rc = TCL_ERROR;
+    }
+
+    Tcl_DecrRefCount(rows);
+    if (nulls) Tcl_DecrRefCount(nulls);
+
+    if (rc != TCL_OK) {
+        return TCL_ERROR;
+    }
+    Tcl_SetObjResult(interp, Tcl_NewIntObj(numFetched));
+    return TCL_OK;
+}
+
+int SdbStmt::fetchColumns(Tcl_Interp* interp, int limit, Tcl_Obj* colsVar, Tcl_Obj* nullsVar)
+{
+    int numCols = cols.size();
+
+    // values of the columns with the same label would overwrite each other in the dict
+    for (int colIdx = 1; colIdx < numCols; colIdx++) {
+        const char* label = Tcl_GetString(cols[colIdx].label);
+        for (int prevIdx = 0; prevIdx < colIdx; prevIdx++) {
+            if (strcmp(label, Tcl_GetString(cols[prevIdx].label)) == 0) {
+                Tcl_AppendResult(interp, "more than one column is labeled ", label, ", use column aliases to fetch them into a dict", nullptr);
+                return TCL_ERROR;
+            }
+        }
+    }
+
+    Tcl_Obj* values[numCols];
+    for (int colIdx = 0; colIdx < numCols; colIdx++) {
+        Tcl_IncrRefCount(values[colIdx] = Tcl_NewListObj(0, nullptr));
+    }
+    std::vector<std::vector<unsigned char>> nullBits(nullsVar ? numCols : 0);
+
+    Tcl_Obj* tclNull = TCL_VAL(nullValue);
+
+    int rc         = TCL_OK;
+    int numFetched = 0;
+    while (rc == TCL_OK && (limit <= 0 || numFetched < limit)) {
+        SQLDBC_UInt4 numRows = COLUMNS_ROW_SET_SIZE;
+        if (limit > 0 && limit - numFetched < numRows) {
+            numRows = limit - numFetched;
+        }
+        int numRowSetRows;
+        rc = fetchRowSet(interp, numRows, &numRowSetRows);
+        if (rc != TCL_OK || numRowSetRows == 0) {
+            break;
+        }
+        for (int colIdx = 0; colIdx < numCols && rc == TCL_OK; colIdx++) {
+            for (int row = 0; row < numRowSetRows; row++) {
+                Tcl_Obj* value = getRowSetValue(interp, colIdx, row, tclNull);
+                if (value == nullptr) {
+                    rc = TCL_ERROR;
+                    break;
+                }
+                Tcl_ListObjAppendElement(nullptr, values[colIdx], value);
+                if (nullsVar) {
+                    std::vector<unsigned char>& bits = nullBits[colIdx];
+                    int                         bit  = numFetched + row;
+                    if (bits.size() <= bit / 8) {
+                        bits.resize(bit / 8 + 1);
+                    }
+                    if (value == tclNull) {
+                        bits[bit / 8] |= 1 << (bit % 8);
+                    }
+                }
+            }
+        }
+        numFetched += numRowSetRows;
+        if (numRowSetRows < numRows) {
+            break;
+        }
+    }
+
+    if (rc == TCL_OK) {
+        Tcl_Obj* colsDict = Tcl_NewDictObj();
+        for (int colIdx = 0; colIdx < numCols; colIdx++) {
+            Tcl_DictObjPut(nullptr, colsDict, cols[colIdx].label, values[colIdx]);
+        }
+        if (Tcl_ObjSetVar2(interp, colsVar, nullptr, colsDict, TCL_LEAVE_ERR_MSG) == nullptr) {
+            rc = TCL_ERROR;
+        }
+    }
+    if (rc == TCL_OK && nullsVar) {
+        Tcl_Obj* nullsDict = Tcl_NewDictObj();
+        for (int colIdx = 0; colIdx < numCols; colIdx++) {
+            std::vector<unsigned char>& bits = nullBits[colIdx];
+            bits.resize((numFetched + 7) / 8);
+            Tcl_DictObjPut(nullptr, nullsDict, cols[colIdx].label, Tcl_NewByteArrayObj(bits.data(), bits.size()));
+        }
+        if (Tcl_ObjSetVar2(interp, nullsVar, nullptr, nullsDict, TCL_LEAVE_ERR_MSG) == nullptr) {
+            rc = TCL_ERROR;
+        }
+    }
+
+    for (int colIdx = 0; colIdx < numCols; colIdx++) {
+        Tcl_DecrRefCount(values[colIdx]);
+    }
+
+    if (rc != TCL_OK) {
+        return TCL_ERROR;
+    }
+    Tcl_SetObjResult(interp, Tcl_NewIntObj(numFetched));
+    return TCL_OK;
+}
+
+// ------------------------------------------------------------------------------------------------
+
+Param::Param(SQLDBC_ParameterMetaData* info, int paramNo, DateTimeMode dateTimeMode, DecimalMode decimalMode) : inBufferLength(0), boundArg(nullptr), isBound(false), lobSource(nullptr), name(nullptr), key(nullptr), outVarName(nullptr), outVarKey(nullptr), dateTimeMode(dateTimeMode)
+{
+    sqlType    = info->getParameterType(paramNo);
+    length     = info->getParameterLength(paramNo);
+    precision  = info->getPrecision(paramNo);
+    scale      = info->getScale(paramNo);
+    byteLength = info->getPhysicalLength(paramNo);
+    inOutMode  = info->getParameterMode(paramNo);
+
+    switch (sqlType) {
+        case SQLDBC_SQLTYPE_FIXED:
+        case SQLDBC_SQLTYPE_FLOAT:
+        case SQLDBC_SQLTYPE_VFLOAT:
+            if (isPackedDecimal(sqlType, precision, scale, decimalMode))
+                hostType = SQLDBC_HOSTTYPE_DECIMAL;
+            else if (precision > 15)
+                hostType = SQLDBC_HOSTTYPE_UTF8;
+            else if (scale > 0)
+                hostType = SQLDBC_HOSTTYPE_DOUBLE;
+            else if (precision > 9)
+                hostType = SQLDBC_HOSTTYPE_INT8;
+            else
+                hostType = SQLDBC_HOSTTYPE_INT4;
+            break;
+        case SQLDBC_SQLTYPE_BOOLEAN:
+        case SQLDBC_SQLTYPE_SMALLINT:
+        case SQLDBC_SQLTYPE_INTEGER:   hostType = SQLDBC_HOSTTYPE_INT4; break;
+        case SQLDBC_SQLTYPE_CHB:
+        case SQLDBC_SQLTYPE_VARCHARB:
+        case SQLDBC_SQLTYPE_STRB:
+        case SQLDBC_SQLTYPE_LONGB:     hostType = SQLDBC_HOSTTYPE_BINARY; break;
+        case SQLDBC_SQLTYPE_DATE:      hostType = dateTimeHostType(SQLDBC_HOSTTYPE_ODBCDATE, dateTimeMode); break;
+        case SQLDBC_SQLTYPE_TIME:      hostType = dateTimeHostType(SQLDBC_HOSTTYPE_ODBCTIME, dateTimeMode); break;
+        case SQLDBC_SQLTYPE_TIMESTAMP: hostType = dateTimeHostType(SQLDBC_HOSTTYPE_ODBCTIMESTAMP, dateTimeMode); break;
+        default:                       hostType = SQLDBC_HOSTTYPE_UTF8;
+    }
+
+    dataLength        = 0;
+    outData.charValue = nullptr;
+
+    if (isOut()) {
+        switch (hostType) {
+            case SQLDBC_HOSTTYPE_INT4:          byteLength = sizeof(int); break;
+            case SQLDBC_HOSTTYPE_INT8:          byteLength = sizeof(Tcl_WideInt); break;
+            case SQLDBC_HOSTTYPE_DOUBLE:        byteLength = sizeof(double); break;
+            case SQLDBC_HOSTTYPE_ODBCDATE:      byteLength = sizeof(SQL_DATE_STRUCT); break;
+            case SQLDBC_HOSTTYPE_ODBCTIME:      byteLength = sizeof(SQL_TIME_STRUCT); break;
+            case SQLDBC_HOSTTYPE_ODBCTIMESTAMP: byteLength = sizeof(SQL_TIMESTAMP_STRUCT); break;
+            case SQLDBC_HOSTTYPE_DECIMAL:       byteLength = decimalSize(precision); break;
+            case SQLDBC_HOSTTYPE_BINARY: {
+                outData.charValue = Tcl_Alloc(byteLength);
+                break;
+            }
+            default: {
+                byteLength        = length * TCL_UTF_MAX;
+                outData.charValue = Tcl_Alloc(byteLength + 1);
+            }
+        }
+    } else if (!isLongType(sqlType)) {
+        // LONG values are bound directly as they might be too large to be copied
+        switch (hostType) {
+            case SQLDBC_HOSTTYPE_BINARY: inBufferLength = byteLength; break;
+            case SQLDBC_HOSTTYPE_UTF8:   inBufferLength = length * TCL_UTF_MAX; break;
+            default:                     inBufferLength = getValueSize();
+        }
+        if (isVarChar()) {
+            outData.charValue = Tcl_Alloc(inBufferLength > 0 ? inBufferLength : 1);
+        }
+    }
+}
+
+Param::~Param()
+{
+    if (name) Tcl_DecrRefCount(name);
+    if (key) Tcl_DecrRefCount(key);
+    if (outVarKey) Tcl_DecrRefCount(outVarKey);
+    forgetBoundArg();
+    forgetLobSource();
+    if (isVarChar() && outData.charValue != nullptr) Tcl_Free(outData.charValue);
+}
+
+/**
+ * Checks whether the argument of the date-time parameter is an epoch value. Only integer values are
+ * taken as epochs, as strings of digits might be dates in the INTERNAL format, like 20240101.
+ */
+static inline bool getEpochArg (Tcl_Obj* arg, Tcl_WideInt* epochPtr)
+{
+    if (arg->typePtr != tclIntType && arg->typePtr != tclWideIntType) {
+        return false;
+    }
+    return Tcl_GetWideIntFromObj(nullptr, arg, epochPtr) == TCL_OK;
+}
+
+/**
+ * Reports the epoch value which date cannot be stored in the database.
+ */
+static int badEpoch (Tcl_Interp* interp, Tcl_WideInt epoch)
+{
+    char epochStr[24];
+    snprintf(epochStr, sizeof(epochStr), "%lld", (long long) epoch);
+    Tcl_AppendResult(interp, "epoch value ", epochStr, " is outside of the supported date range", nullptr);
+    return TCL_ERROR;
+}
+
+/**
+ * Checks whether the argument is an empty string, which is bound as NULL.
+ */
+static inline bool isNullArg (Tcl_Obj* arg)
+{
+    if (arg->typePtr == nullptr || arg->typePtr == tclStringType) {
+        int strLen;
+        Tcl_GetStringFromObj(arg, &strLen);
+        return strLen == 0;
+    }
+    return false;
+}
+
+bool Param::checkAndSetNull(Tcl_Obj* arg)
+{
+    if (isNullArg(arg)) {
+        dataLength = SQLDBC_NULL_DATA;
+        return true;
+    }
+    return false;
+}
+
+SQLDBC_Length Param::getValueSize()
+{
+    switch (hostType) {
+        case SQLDBC_HOSTTYPE_INT4:          return sizeof(int);
+        case SQLDBC_HOSTTYPE_INT8:          return sizeof(Tcl_WideInt);
+        case SQLDBC_HOSTTYPE_DOUBLE:        return sizeof(double);
+        case SQLDBC_HOSTTYPE_ODBCDATE:      return sizeof(SQL_DATE_STRUCT);
+        case SQLDBC_HOSTTYPE_ODBCTIME:      return sizeof(SQL_TIME_STRUCT);
+        case SQLDBC_HOSTTYPE_ODBCTIMESTAMP: return sizeof(SQL_TIMESTAMP_STRUCT);
+        case SQLDBC_HOSTTYPE_DECIMAL:       return decimalSize(precision);
+        default:                            return byteLength;
+    }
+}
+
+bool Param::fitsLength(const char* text, int len)
+{
+    if (isLongType(sqlType)) {
+        return true;
+    }
+    switch (hostType) {
+        case SQLDBC_HOSTTYPE_BINARY:
+            return len <= byteLength;
+        case SQLDBC_HOSTTYPE_UTF8:
+            switch (sqlType) {
+                case SQLDBC_SQLTYPE_FIXED:
+                case SQLDBC_SQLTYPE_FLOAT:
+                case SQLDBC_SQLTYPE_VFLOAT:
+                case SQLDBC_SQLTYPE_DATE:
+                case SQLDBC_SQLTYPE_TIME:
+                case SQLDBC_SQLTYPE_TIMESTAMP:
+                    // the length of numbers and dates is their precision, which the database checks
+                    return true;
+                default:
+                    return len <= length || Tcl_NumUtfChars(text, len) <= length;
+            }
+        default:
+            return true;
+    }
+}
+
+int Param::copyValue(Tcl_Interp* interp, Tcl_Obj* arg, int idx, void* data, SQLDBC_Length* lengthPtr, SQLDBC_Length bufferLength)
+{
+    if (isNullArg(arg)) {
+        *lengthPtr = SQLDBC_NULL_DATA;
+        return TCL_OK;
+    }
+    if (arg->typePtr == &sdbLobSourceType) {
+        TclSetResult(interp, "LOB source can only be bound to a LONG parameter of a single execution", TCL_STATIC);
+        return TCL_ERROR;
+    }
+
+    switch (hostType) {
+        case SQLDBC_HOSTTYPE_INT4:
+            if (Tcl_GetIntFromObj(interp, arg, (int*) data) != TCL_OK) return TCL_ERROR;
+            *lengthPtr = sizeof(int);
+            break;
+        case SQLDBC_HOSTTYPE_INT8:
+            if (Tcl_GetWideIntFromObj(interp, arg, (Tcl_WideInt*) data) != TCL_OK) return TCL_ERROR;
+            *lengthPtr = sizeof(Tcl_WideInt);
+            break;
+        case SQLDBC_HOSTTYPE_DOUBLE:
+            if (Tcl_GetDoubleFromObj(interp, arg, (double*) data) != TCL_OK) return TCL_ERROR;
+            *lengthPtr = sizeof(double);
             break;
-        case SQLDBC_HOSTTYPE_BINARY: {
-            int   len;
-            void* data = Tcl_GetByteArrayFromObj(arg, &len);
-            if (len > byteLength) {
-                char posStr[8], lenStr[12], byteLenStr[8];
+        case SQLDBC_HOSTTYPE_ODBCDATE:
+        case SQLDBC_HOSTTYPE_ODBCTIME:
+        case SQLDBC_HOSTTYPE_ODBCTIMESTAMP: {
+            Tcl_WideInt epoch;
+            if (Tcl_GetWideIntFromObj(interp, arg, &epoch) != TCL_OK) return TCL_ERROR;
+            *lengthPtr = epochToDateTime(hostType, epoch, epochUnitsPerSecond(dateTimeMode), data);
+            if (*lengthPtr < 0) return badEpoch(interp, epoch);
+            break;
+        }
+        case SQLDBC_HOSTTYPE_DECIMAL:
+            if (packDecimal(interp, arg, precision, (unsigned char*) data) != TCL_OK) return TCL_ERROR;
+            *lengthPtr = SQLDBC_LEN_DECIMAL(precision, scale);
+            break;
+        default: {
+            int         len;
+            const void* value = (hostType == SQLDBC_HOSTTYPE_BINARY ? (const void*) Tcl_GetByteArrayFromObj(arg, &len) : (const void*) Tcl_GetStringFromObj(arg, &len));
+            if (len > bufferLength) {
+                char posStr[8], lenStr[12], bufLenStr[12];
                 snprintf(posStr, sizeof(posStr), "%u", idx);
                 snprintf(lenStr, sizeof(lenStr), "%u", len);
-                snprintf(byteLenStr, sizeof(byteLenStr), "%u", byteLength);
-                Tcl_AppendResult(interp, "argument ", posStr, "[", lenStr, "] is longer than max paramerer length of ", byteLength, nullptr);
+                snprintf(bufLenStr, sizeof(bufLenStr), "%u", (unsigned) bufferLength);
+                Tcl_AppendResult(interp, "argument ", posStr, "[", lenStr, "] is longer than max parameter length of ", bufLenStr, nullptr);
                 return TCL_ERROR;
             }
-            dataLength = len;
-            std::memcpy(outData.charValue, data, len);
+            *lengthPtr = len;
+            std::memcpy(data, value, len);
+        }
+    }
+    return TCL_OK;
+}
+
+/**
+ * Returns an error for the text that cannot be converted into the parameter's value.
+ */
+static int badText (Tcl_Interp* interp, const char* expected, const char* text)
+{
+    Tcl_AppendResult(interp, "expected ", expected, " but got \"", text, "\"", nullptr);
+    return TCL_ERROR;
+}
+
+int Param::copyText(Tcl_Interp* interp, const char* text, int len, int idx, void* data, SQLDBC_Length* lengthPtr, SQLDBC_Length bufferLength)
+{
+    char* end;
+    errno = 0;
+    switch (hostType) {
+        case SQLDBC_HOSTTYPE_INT4: {
+            long val = std::strtol(text, &end, 10);
+            if (end == text || *end != '\0' || errno == ERANGE || val < INT_MIN || INT_MAX < val) return badText(interp, "integer", text);
+            *(int*) data = val;
+            *lengthPtr   = sizeof(int);
             break;
         }
-        default: {
-            int   len;
-            void* data = Tcl_GetStringFromObj(arg, &len);
-            if (len > byteLength) {
-                char posStr[8], lenStr[12], byteLenStr[8];
+        case SQLDBC_HOSTTYPE_INT8:
+            *(Tcl_WideInt*) data = std::strtoll(text, &end, 10);
+            if (end == text || *end != '\0' || errno == ERANGE) return badText(interp, "integer", text);
+            *lengthPtr = sizeof(Tcl_WideInt);
+            break;
+        case SQLDBC_HOSTTYPE_DOUBLE:
+            *(double*) data = std::strtod(text, &end);
+            if (end == text || *end != '\0') return badText(interp, "floating-point number", text);
+            *lengthPtr = sizeof(double);
+            break;
+        case SQLDBC_HOSTTYPE_ODBCDATE:
+        case SQLDBC_HOSTTYPE_ODBCTIME:
+        case SQLDBC_HOSTTYPE_ODBCTIMESTAMP: {
+            Tcl_WideInt epoch = std::strtoll(text, &end, 10);
+            if (end == text || *end != '\0' || errno == ERANGE) return badText(interp, "epoch value", text);
+            *lengthPtr = epochToDateTime(hostType, epoch, epochUnitsPerSecond(dateTimeMode), data);
+            if (*lengthPtr < 0) return badEpoch(interp, epoch);
+            break;
+        }
+        case SQLDBC_HOSTTYPE_DECIMAL: {
+            Tcl_Obj* arg = Tcl_NewStringObj(text, len);
+            Tcl_IncrRefCount(arg);
+            int rc = copyValue(interp, arg, idx, data, lengthPtr, bufferLength);
+            Tcl_DecrRefCount(arg);
+            return rc;
+        }
+        default:
+            if (len > bufferLength) {
+                char posStr[8], lenStr[12], bufLenStr[12];
                 snprintf(posStr, sizeof(posStr), "%u", idx);
                 snprintf(lenStr, sizeof(lenStr), "%u", len);
-                snprintf(byteLenStr, sizeof(byteLenStr), "%u", byteLength);
-                Tcl_AppendResult(interp, "argument ", posStr, "[", lenStr, "] is longer than max paramerer length of ", byteLength, nullptr);
+                snprintf(bufLenStr, sizeof(bufLenStr), "%u", (unsigned) bufferLength);
+                Tcl_AppendResult(interp, "argument ", posStr, "[", lenStr, "] is longer than max parameter length of ", bufLenStr, nullptr);
                 return TCL_ERROR;
             }
-            dataLength = len;
-            std::memcpy(outData.charValue, data, len);
-        }
+            *lengthPtr = len;
+            std::memcpy(data, text, len);
     }
     return TCL_OK;
 }
 
+int Param::copyIntoOutDataBuffer(Tcl_Interp* interp, Tcl_Obj* arg, int idx)
+{
+    void* data = (isVarChar() ? (void*) outData.charValue : (void*) &outData);
+    return copyValue(interp, arg, idx, data, &dataLength, byteLength);
+}
+
 void Param::bindOutDataBufferTo(SQLDBC_PreparedStatement* stmt, int idx)
 {
+    if (hostType == SQLDBC_HOSTTYPE_DECIMAL && !isIn()) {
+        dataLength = SQLDBC_LEN_DECIMAL(precision, scale);
+    }
     stmt->bindParameter(idx, hostType, &outData, &dataLength, byteLength, false);
 }
 
 int Param::bindInTo(SQLDBC_PreparedStatement* stmt, int idx, Tcl_Interp* interp, Tcl_Obj* arg)
 {
-    void* data = nullptr;
+    if (arg->typePtr == &sdbLobSourceType) {
+        return bindSourceTo(stmt, idx, interp, arg);
+    }
+    forgetLobSource();
+    void*           data         = nullptr;
+    SQLDBC_HostType bindHostType = hostType;
     if (!checkAndSetNull(arg)) {
         switch (hostType) {
             case SQLDBC_HOSTTYPE_INT4: {
@@ -670,6 +1494,28 @@ int Param::bindInTo(SQLDBC_PreparedStatement* stmt, int idx, Tcl_Interp* interp,
                 data       = &outData.doubleValue;
                 dataLength = sizeof(double);
                 break;
+            case SQLDBC_HOSTTYPE_ODBCDATE:
+            case SQLDBC_HOSTTYPE_ODBCTIME:
+            case SQLDBC_HOSTTYPE_ODBCTIMESTAMP: {
+                Tcl_WideInt epoch;
+                if (getEpochArg(arg, &epoch)) {
+                    data       = &outData;
+                    dataLength = epochToDateTime(hostType, epoch, epochUnitsPerSecond(dateTimeMode), data);
+                    if (dataLength < 0) return badEpoch(interp, epoch);
+                } else {
+                    // not an epoch value - let the database parse the date/time string
+                    int len;
+                    data         = Tcl_GetStringFromObj(arg, &len);
+                    dataLength   = len;
+                    bindHostType = SQLDBC_HOSTTYPE_UTF8;
+                }
+                break;
+            }
+            case SQLDBC_HOSTTYPE_DECIMAL:
+                if (packDecimal(interp, arg, precision, outData.decimalValue) != TCL_OK) return TCL_ERROR;
+                data       = outData.decimalValue;
+                dataLength = SQLDBC_LEN_DECIMAL(precision, scale);
+                break;
             case SQLDBC_HOSTTYPE_BINARY: {
                 int len;
                 data       = Tcl_GetByteArrayFromObj(arg, &len);
@@ -683,31 +1529,124 @@ int Param::bindInTo(SQLDBC_PreparedStatement* stmt, int idx, Tcl_Interp* interp,
             }
         }
     }
-    stmt->bindParameter(idx, hostType, data, &dataLength, dataLength, false);
+    SQLDBC_Length bufferLength = (bindHostType == SQLDBC_HOSTTYPE_DECIMAL ? decimalSize(precision) : dataLength);
+    stmt->bindParameter(idx, bindHostType, data, &dataLength, bufferLength, false);
+    return TCL_OK;
+}
+
+int Param::bindSourceTo(SQLDBC_PreparedStatement* stmt, int idx, Tcl_Interp* interp, Tcl_Obj* arg)
+{
+    if (!isLongType(sqlType)) {
+        TclSetResult(interp, "LOB source can only be bound to a LONG parameter of a single execution", TCL_STATIC);
+        return TCL_ERROR;
+    }
+    SdbLobSource* source = (SdbLobSource*) arg->internalRep.otherValuePtr;
+    source->preserve();
+    forgetLobSource();
+    lobSource  = source;
+    dataLength = source->getLengthIndicator();
+    // the address only identifies the parameter, the data are sent by putLobSources
+    stmt->bindParameter(idx, hostType, this, &dataLength, 0, false);
+    return TCL_OK;
+}
+
+void Param::forgetLobSource()
+{
+    if (lobSource) {
+        lobSource->release();
+        lobSource = nullptr;
+    }
+}
+
+void Param::bindInBufferTo(SQLDBC_PreparedStatement* stmt, int idx)
+{
+    void* data = (isVarChar() ? (void*) outData.charValue : (void*) &outData);
+    stmt->bindParameter(idx, hostType, data, &dataLength, inBufferLength, false);
+    isBound = true;
+    forgetBoundArg();
+}
+
+void Param::forgetBoundArg()
+{
+    if (boundArg) {
+        Tcl_DecrRefCount(boundArg);
+        boundArg = nullptr;
+    }
+}
+
+int Param::setInput(SQLDBC_PreparedStatement* stmt, int idx, Tcl_Interp* interp, Tcl_Obj* arg)
+{
+    if (!hasInBuffer()) {
+        return bindInTo(stmt, idx, interp, arg);
+    }
+    // held arguments are shared, so they cannot be changed in place
+    if (isBound && arg == boundArg) {
+        return TCL_OK;
+    }
+    Tcl_WideInt epoch;
+    if (isDateTime() && !isNullArg(arg) && !getEpochArg(arg, &epoch)) {
+        // not an epoch value - the database will parse the date/time string
+        isBound = false;
+        forgetBoundArg();
+        return bindInTo(stmt, idx, interp, arg);
+    }
+    if (!isBound) {
+        bindInBufferTo(stmt, idx);
+    }
+    forgetBoundArg();
+    void* data = (isVarChar() ? (void*) outData.charValue : (void*) &outData);
+    if (copyValue(interp, arg, idx, data, &dataLength, inBufferLength) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    boundArg = arg;
+    Tcl_IncrRefCount(boundArg);
     return TCL_OK;
 }
 
 Tcl_Obj* Param::getOutObj()
 {
     switch (hostType) {
-        case SQLDBC_HOSTTYPE_INT4:   return Tcl_NewIntObj(outData.intValue);
-        case SQLDBC_HOSTTYPE_INT8:   return Tcl_NewWideIntObj(outData.wideIntValue);
-        case SQLDBC_HOSTTYPE_DOUBLE: return Tcl_NewDoubleObj(outData.doubleValue);
-        case SQLDBC_HOSTTYPE_BINARY: return Tcl_NewByteArrayObj((unsigned char*) outData.charValue, dataLength);
-        default:                     return Tcl_NewStringObj(outData.charValue, dataLength);
+        case SQLDBC_HOSTTYPE_INT4:          return Tcl_NewIntObj(outData.intValue);
+        case SQLDBC_HOSTTYPE_INT8:          return Tcl_NewWideIntObj(outData.wideIntValue);
+        case SQLDBC_HOSTTYPE_DOUBLE:        return Tcl_NewDoubleObj(outData.doubleValue);
+        case SQLDBC_HOSTTYPE_ODBCDATE:
+        case SQLDBC_HOSTTYPE_ODBCTIME:
+        case SQLDBC_HOSTTYPE_ODBCTIMESTAMP: return Tcl_NewWideIntObj(dateTimeToEpoch(hostType, &outData, epochUnitsPerSecond(dateTimeMode)));
+        case SQLDBC_HOSTTYPE_DECIMAL:       return newDecimalObj(outData.decimalValue, precision);
+        case SQLDBC_HOSTTYPE_BINARY:        return Tcl_NewByteArrayObj((unsigned char*) outData.charValue, dataLength);
+        default:                            return Tcl_NewStringObj(outData.charValue, dataLength);
     }
 }
 
-SdbPrepStmt::SdbPrepStmt(SdbConn* conn) : SdbStmt(conn, 0)
+/**
+ * Name of the parameter which internal representation is the list of indexes of the parameters
+ * with this name in the statement it was last used with. The statement is identified by its
+ * prepare stamp, so the indexes are never used with other statements, even if the statement
+ * was destroyed and another one was created at the same address.
+ */
+static Tcl_ObjType sdbParamNameType = {
+    .name = (char*) "sdbparamname",
+};
+
+/**
+ * Source of prepare stamps that are unique within the process.
+ */
+static std::atomic<unsigned long> lastPrepareStamp(0);
+
+SdbPrepStmt::SdbPrepStmt(SdbConn* conn) : SdbStmt(conn, 0), isInCache(false)
 {
     stmt = conn->createPreparedStatement();
+    conn->addStatement(this);
 }
 
 void SdbPrepStmt::releaseDatabaseHandles()
 {
     if (conn) {
         if (stmt) {
+            // the statement might be released while LOBs of the connection are read ahead
+            conn->pauseLobReads();
             if (rset) {
+                freeResultBuffers();
                 rset     = nullptr;
                 rsetInfo = nullptr;
                 cols.clear();
@@ -734,47 +1673,56 @@ int SdbPrepStmt::prepare(Tcl_Interp* interp, Tcl_Obj* sqlObj)
     params.clear();
     params.reserve(paramCount);
     for (int paramNo = 1; paramNo <= paramCount; paramNo++) {
-        params.emplace_back(paramsInfo, paramNo);
+        params.emplace_back(paramsInfo, paramNo, dateTimeMode, decimalMode);
     }
 
     if (paramCount > 0) {
-        static Tcl_Obj* paramFindPattern = Tcl_NewStringObj(":\\w+|\\?", 7);
-        Tcl_RegExp      re               = Tcl_GetRegExpFromObj(interp, paramFindPattern, TCL_REG_ADVANCED);
-        enum { NONE, POS, NAMED, BADMIX };
-        int typeMix = NONE;
-        int paramNo = 0;
-        int res     = Tcl_RegExpExec(interp, re, sql, sql);
-        while (res > 0) {
-            if (paramNo >= paramCount) {
-                TclSetResult(interp, "sdbtcl SQL scanner found more parameters than the database reported", TCL_STATIC);
-                return TCL_ERROR;
-            }
-            const char* start;
-            const char* end;
-            Tcl_RegExpRange(re, 0, &start, &end);
-            if (*start == '?') {
-                typeMix |= POS;
-                ++paramNo;
-            } else {
-                typeMix |= NAMED;
-                Param& param = params.at(paramNo++);
-                param.name   = Tcl_NewStringObj(start, end - start);
-            }
-            res = Tcl_RegExpExec(interp, re, end, sql);
+        const SqlParams& markers = conn->scanParams(sql, sqlLen);
+        if (markers.names.size() > (size_t) paramCount) {
+            TclSetResult(interp, "sdbtcl SQL scanner found more parameters than the database reported", TCL_STATIC);
+            return TCL_ERROR;
         }
-        if (paramNo < paramCount) {
+        if (markers.names.size() < (size_t) paramCount) {
             TclSetResult(interp, "sdbtcl SQL scanner has not found all the parameters that the database reported", TCL_STATIC);
             return TCL_ERROR;
         }
-        if (typeMix == BADMIX) {
+        if (markers.hasPositional && markers.hasNamed) {
             TclSetResult(interp, "sdbtcl does not support mixing named and positional parameters in the same SQL", TCL_STATIC);
             return TCL_ERROR;
         }
+        for (int idx = 0; idx < paramCount; idx++) {
+            Tcl_Obj* name = markers.names[idx];
+            if (name) {
+                int         len;
+                const char* str = Tcl_GetStringFromObj(name, &len);
+
+                Param& param = params[idx];
+                param.name   = name;
+                param.key    = Tcl_NewStringObj(str + 1, len - 1);
+                Tcl_IncrRefCount(param.name);
+                Tcl_IncrRefCount(param.key);
+            }
+        }
+    }
+
+    paramIndex.clear();
+    for (int idx = 0; idx < paramCount; idx++) {
+        Tcl_Obj* name = params[idx].name;
+        if (name) {
+            int         len;
+            const char* str = Tcl_GetStringFromObj(name, &len);
+
+            std::string key(str, len);
+            key.resize(Tcl_UtfToUpper(&key[0]));
+            paramIndex[key].push_back(idx);
+        }
     }
+    prepareStamp = ++lastPrepareStamp;
+    bindInBuffers();
     return TCL_OK;
 }
 
-int SdbPrepStmt::bind(Tcl_Interp* interp, int argc, Tcl_Obj* const argv[])
+int SdbPrepStmt::checkArgCount(Tcl_Interp* interp, int argc)
 {
     bool isPositional = params.size() > 0 && params.at(0).name == nullptr;
     if (isPositional && argc != params.size()) {
@@ -784,60 +1732,185 @@ int SdbPrepStmt::bind(Tcl_Interp* interp, int argc, Tcl_Obj* const argv[])
         Tcl_AppendResult(interp, sizeStr, " arguments are expected, ", argcStr, " were provided", nullptr);
         return TCL_ERROR;
     }
-    if (!isPositional && argc != params.size() * 2) {
+    // the same named parameter might be used several times, but its argument is provided once
+    if (!isPositional && argc != paramIndex.size() * 2) {
         char sizeStr[12], argcStr[12];
-        snprintf(sizeStr, sizeof(sizeStr), "%zu", params.size());
+        snprintf(sizeStr, sizeof(sizeStr), "%zu", paramIndex.size());
         snprintf(argcStr, sizeof(argcStr), "%i", argc / 2);
         Tcl_AppendResult(interp, sizeStr, " named arguments are expected, ", argcStr, " were provided", nullptr);
         return TCL_ERROR;
     }
+    return TCL_OK;
+}
 
-    int bindIdx = 0;
-    for (int i = 0; i < argc;) {
-        Param* param;
-        if (isPositional) {
-            param = &params.at(bindIdx++);
-        } else if (argv[i]->typePtr == nullptr || argv[i]->typePtr == tclStringType) {
-            int         len;
-            const char* name = Tcl_GetStringFromObj(argv[i++], &len);
+const std::vector<int>* SdbPrepStmt::findParam(Tcl_Obj* nameObj)
+{
+    if (nameObj->typePtr == &sdbParamNameType && nameObj->internalRep.ptrAndLongRep.value == prepareStamp) {
+        return (const std::vector<int>*) nameObj->internalRep.ptrAndLongRep.ptr;
+    }
 
-            int idx = 0;
-            for (auto it = params.begin(); it != params.end(); ++it, ++idx) {
-                int         paramNameLen;
-                const char* paramName = Tcl_GetStringFromObj(it->name, &paramNameLen);
-                if (paramNameLen == len && strncasecmp(paramName, name, len) == 0) {
-                    break;
-                }
+    int         len;
+    const char* name = Tcl_GetStringFromObj(nameObj, &len);
+
+    std::string key(name, len);
+    key.resize(Tcl_UtfToUpper(&key[0]));
+
+    auto found = paramIndex.find(key);
+    if (found == paramIndex.end()) {
+        return nullptr;
+    }
+    if (nameObj->typePtr == nullptr || nameObj->typePtr == tclStringType || nameObj->typePtr == &sdbParamNameType) {
+        TclFreeIntRep(nameObj);
+        nameObj->internalRep.ptrAndLongRep.ptr   = &found->second;
+        nameObj->internalRep.ptrAndLongRep.value = prepareStamp;
+        nameObj->typePtr                         = &sdbParamNameType;
+    }
+    return &found->second;
+}
+
+const std::vector<int>* SdbPrepStmt::findParamByKey(Tcl_Obj* keyObj)
+{
+    int         len;
+    const char* key = Tcl_GetStringFromObj(keyObj, &len);
+
+    std::string name(1, ':');
+    name.append(key, len);
+    name.resize(Tcl_UtfToUpper(&name[0]));
+
+    auto found = paramIndex.find(name);
+    return found != paramIndex.end() ? &found->second : nullptr;
+}
+
+void SdbPrepStmt::bindInBuffers()
+{
+    for (size_t idx = 0; idx < params.size(); idx++) {
+        Param& param = params[idx];
+        if (param.hasInBuffer()) {
+            param.bindInBufferTo(prepstmt(), idx + 1);
+        }
+    }
+}
+
+int SdbPrepStmt::bindArg(Tcl_Interp* interp, int idx, Tcl_Obj* arg, Tcl_Obj* key)
+{
+    Param& param   = params.at(idx);
+    int    bindIdx = idx + 1;
+    if (param.isOut()) {
+        if (param.isIn()) {
+            Tcl_Obj* val = Tcl_ObjGetVar2(interp, arg, key, TCL_LEAVE_ERR_MSG);
+            if (val == nullptr) {
+                return TCL_ERROR;
             }
-            if (idx == params.size()) {
-                Tcl_AppendResult(interp, "cannot find parameter ", name, " in the statement", nullptr);
+            if (param.copyIntoOutDataBuffer(interp, val, bindIdx) != TCL_OK) {
                 return TCL_ERROR;
             }
-            param   = &params.at(idx);
-            bindIdx = idx + 1;
-        } else {
-            Tcl_AppendResult(interp, "cannot use ", Tcl_GetString(argv[i]), " as a parameter name", nullptr);
+        }
+        param.bindOutDataBufferTo(prepstmt(), bindIdx);
+        // the key might be taken from the array elements that are released after binding
+        if (key) Tcl_IncrRefCount(key);
+        if (param.outVarKey) Tcl_DecrRefCount(param.outVarKey);
+        param.outVarName = arg;
+        param.outVarKey  = key;
+    } else {
+        if (param.setInput(prepstmt(), bindIdx, interp, arg) != TCL_OK) {
             return TCL_ERROR;
         }
-        Tcl_Obj* arg = argv[i++];
+        param.outVarName = nullptr;
+    }
+    return TCL_OK;
+}
 
-        if (param->isOut()) {
-            if (param->isIn()) {
-                Tcl_Obj* val = Tcl_ObjGetVar2(interp, arg, nullptr, TCL_LEAVE_ERR_MSG);
-                if (val == nullptr) {
-                    return TCL_ERROR;
-                }
-                if (param->copyIntoOutDataBuffer(interp, val, bindIdx) != TCL_OK) {
-                    return TCL_ERROR;
+int SdbPrepStmt::bindFrom(Tcl_Interp* interp, Tcl_Obj* source, Tcl_Obj* arg)
+{
+    static const char* sources[] = {"-array", "-dict", NULL};
+    enum { ARRAY, DICT } src;
+
+    if (Tcl_GetIndexFromObj(interp, source, sources, "option", 0, (int*) &src) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    // array elements are taken as a dict, so both are matched to the parameters regardless of
+    // the case of their keys, like the names of the named arguments
+    Tcl_Obj* entries = arg;
+    if (src == ARRAY) {
+        Tcl_Obj* words[] = {Tcl_NewStringObj("array", 5), Tcl_NewStringObj("get", 3), arg};
+        Tcl_Obj* getCmd  = Tcl_NewListObj(3, words);
+        Tcl_IncrRefCount(getCmd);
+        int rc = Tcl_EvalObjEx(interp, getCmd, 0);
+        Tcl_DecrRefCount(getCmd);
+        if (rc != TCL_OK) {
+            return TCL_ERROR;
+        }
+        entries = Tcl_GetObjResult(interp);
+    }
+    Tcl_IncrRefCount(entries);
+    Tcl_ResetResult(interp);
+
+    std::vector<Tcl_Obj*> keys(params.size(), nullptr);
+    std::vector<Tcl_Obj*> vals(params.size(), nullptr);
+    Tcl_DictSearch        search;
+    Tcl_Obj*              key;
+    Tcl_Obj*              val;
+    int                   done;
+    int                   rc = Tcl_DictObjFirst(interp, entries, &search, &key, &val, &done);
+    if (rc == TCL_OK) {
+        for (; !done; Tcl_DictObjNext(&search, &key, &val, &done)) {
+            const std::vector<int>* indexes = findParamByKey(key);
+            if (indexes != nullptr) {
+                for (auto it = indexes->cbegin(); it != indexes->cend(); ++it) {
+                    keys[*it] = key;
+                    vals[*it] = val;
                 }
             }
-            param->bindOutDataBufferTo(prepstmt(), bindIdx);
-            param->outVarName = arg;
+        }
+    }
+    for (size_t idx = 0; rc == TCL_OK && idx < params.size(); idx++) {
+        Param& param = params[idx];
+        if (param.isOut()) {
+            if (src == DICT) {
+                Tcl_AppendResult(interp, "OUT parameter ", Tcl_GetString(param.name), " cannot be bound to a dict", nullptr);
+                rc = TCL_ERROR;
+            } else {
+                // the output is stored in the element that matched the parameter
+                rc = bindArg(interp, idx, arg, keys[idx] ? keys[idx] : param.key);
+            }
+        } else if (vals[idx] == nullptr) {
+            Tcl_AppendResult(interp, "argument for parameter ", Tcl_GetString(param.name), " is missing", nullptr);
+            rc = TCL_ERROR;
         } else {
-            if (param->bindInTo(prepstmt(), bindIdx, interp, arg) != TCL_OK) {
+            rc = bindArg(interp, idx, vals[idx]);
+        }
+    }
+    Tcl_DecrRefCount(entries);
+    return rc;
+}
+
+int SdbPrepStmt::bind(Tcl_Interp* interp, int argc, Tcl_Obj* const argv[])
+{
+    if (argc == 2 && params.size() > 0 && params.at(0).name != nullptr && maybeOption(argv[0])) {
+        return bindFrom(interp, argv[0], argv[1]);
+    }
+    if (checkArgCount(interp, argc) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    if (params.size() > 0 && params.at(0).name == nullptr) {
+        for (int i = 0; i < argc; i++) {
+            if (bindArg(interp, i, argv[i]) != TCL_OK) {
+                return TCL_ERROR;
+            }
+        }
+        return TCL_OK;
+    }
+
+    for (int i = 0; i < argc; i += 2) {
+        const std::vector<int>* indexes = findParam(argv[i]);
+        if (indexes == nullptr) {
+            Tcl_AppendResult(interp, "cannot find parameter ", Tcl_GetString(argv[i]), " in the statement", nullptr);
+            return TCL_ERROR;
+        }
+        for (auto it = indexes->cbegin(); it != indexes->cend(); ++it) {
+            if (bindArg(interp, *it, argv[i + 1]) != TCL_OK) {
                 return TCL_ERROR;
             }
-            param->outVarName = nullptr;
         }
     }
     return TCL_OK;
@@ -848,7 +1921,7 @@ int SdbPrepStmt::copyOutput(Tcl_Interp* interp)
     for (auto it = params.begin(); it != params.end(); ++it) {
         if (it->outVarName == nullptr) continue;
         Tcl_Obj* output = it->getOutObj();
-        if (Tcl_ObjSetVar2(interp, it->outVarName, nullptr, output, TCL_LEAVE_ERR_MSG) == nullptr) {
+        if (Tcl_ObjSetVar2(interp, it->outVarName, it->outVarKey, output, TCL_LEAVE_ERR_MSG) == nullptr) {
             Tcl_DecrRefCount(output);
             return TCL_ERROR;
         }
@@ -868,8 +1941,14 @@ int SdbPrepStmt::execute(Tcl_Interp* interp, int idx, int objc, Tcl_Obj* const o
         return TCL_ERROR;
     }
 
-    if (prepstmt()->execute() != SQLDBC_OK) {
+    SQLDBC_Retcode rc = prepstmt()->execute();
+    if (rc == SQLDBC_NEED_DATA) {
+        if (putLobSources(interp) != TCL_OK) {
+            return TCL_ERROR;
+        }
+    } else if (rc != SQLDBC_OK) {
         setTclError(interp, stmt->error());
+        forgetLobSources();
         return TCL_ERROR;
     }
 
@@ -880,12 +1959,364 @@ int SdbPrepStmt::execute(Tcl_Interp* interp, int idx, int objc, Tcl_Obj* const o
     return setExecuteResult(interp);
 }
 
+int SdbPrepStmt::putLobSources(Tcl_Interp* interp)
+{
+    SQLDBC_Int2    paramNo;
+    void*          paramAddr;
+    SQLDBC_Retcode rc;
+    int            result = TCL_OK;
+    while ((rc = prepstmt()->nextParameter(paramNo, paramAddr)) == SQLDBC_NEED_DATA) {
+        SdbLobSource* source = params.at(paramNo - 1).lobSource;
+        if (source == nullptr) {
+            TclSetResult(interp, "parameter data are requested, but there is no LOB source to provide them", TCL_STATIC);
+            result = TCL_ERROR;
+            break;
+        }
+        if (source->putInto(interp, prepstmt(), params.at(paramNo - 1).hostType) != TCL_OK) {
+            result = TCL_ERROR;
+            break;
+        }
+    }
+    if (result == TCL_OK && rc != SQLDBC_OK) {
+        setTclError(interp, stmt->error());
+        result = TCL_ERROR;
+    }
+    forgetLobSources();
+    return result;
+}
+
+void SdbPrepStmt::forgetLobSources()
+{
+    for (auto it = params.begin(); it != params.end(); ++it) {
+        it->forgetLobSource();
+    }
+}
+
+int SdbPrepStmt::orderArgs(Tcl_Interp* interp, int argc, Tcl_Obj* const argv[], Tcl_Obj* args[])
+{
+    if (checkArgCount(interp, argc) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    if (params.size() > 0 && params.at(0).name == nullptr) {
+        std::copy(argv, argv + argc, args);
+        return TCL_OK;
+    }
+
+    std::fill(args, args + params.size(), nullptr);
+    for (int i = 0; i < argc; i += 2) {
+        const std::vector<int>* indexes = findParam(argv[i]);
+        if (indexes == nullptr) {
+            Tcl_AppendResult(interp, "cannot find parameter ", Tcl_GetString(argv[i]), " in the statement", nullptr);
+            return TCL_ERROR;
+        }
+        for (auto it = indexes->cbegin(); it != indexes->cend(); ++it) {
+            args[*it] = argv[i + 1];
+        }
+    }
+    for (size_t idx = 0; idx < params.size(); idx++) {
+        if (args[idx] == nullptr) {
+            Tcl_AppendResult(interp, "argument for parameter ", Tcl_GetString(params.at(idx).name), " is missing", nullptr);
+            return TCL_ERROR;
+        }
+    }
+    return TCL_OK;
+}
+
+ParamArrays::~ParamArrays()
+{
+    if (data) Tcl_Free(data);
+    if (lengths) Tcl_Free((char*) lengths);
+}
+
+int ParamArrays::alloc(Tcl_Interp* interp, int numRows)
+{
+    // Tcl allocates blocks of up to UINT_MAX bytes
+    size_t numParams = valueSizes.size();
+    size_t dataSize  = 0;
+    for (size_t p = 0; p < numParams; p++) {
+        size_t arraySize = alignedValueSize(valueSizes[p] * numRows);
+        if (arraySize > UINT_MAX - dataSize) {
+            TclSetResult(interp, "parameter arrays are too large, use a smaller batch", TCL_STATIC);
+            return TCL_ERROR;
+        }
+        offsets[p] = dataSize;
+        dataSize += arraySize;
+    }
+    if (numRows > 0 && numParams > UINT_MAX / sizeof(SQLDBC_Length) / numRows) {
+        TclSetResult(interp, "parameter arrays are too large, use a smaller batch", TCL_STATIC);
+        return TCL_ERROR;
+    }
+    this->numRows = numRows;
+
+    data    = Tcl_AttemptAlloc(dataSize > 0 ? dataSize : 1);
+    lengths = (SQLDBC_Length*) Tcl_AttemptAlloc(sizeof(SQLDBC_Length) * (numParams > 0 ? numParams * numRows : 1));
+    if (data == nullptr || lengths == nullptr) {
+        TclSetResult(interp, "cannot allocate parameter arrays", TCL_STATIC);
+        return TCL_ERROR;
+    }
+    return TCL_OK;
+}
+
+int SdbPrepStmt::checkInputOnly(Tcl_Interp* interp)
+{
+    for (auto it = params.begin(); it != params.end(); ++it) {
+        if (it->isOut()) {
+            TclSetResult(interp, "statements with output parameters cannot be executed with multiple argument rows", TCL_STATIC);
+            return TCL_ERROR;
+        }
+    }
+    return TCL_OK;
+}
+
+int SdbPrepStmt::executeArrays(Tcl_Interp* interp, ParamArrays& arrays, int numRows)
+{
+    if (prepstmt()->setBatchSize(numRows) != SQLDBC_OK) {
+        setTclError(interp, stmt->error());
+        return TCL_ERROR;
+    }
+    // Column-wise binding - arguments of each parameter are stored in the adjacent array elements
+    for (size_t p = 0; p < params.size(); p++) {
+        if (prepstmt()->bindParameter(p + 1, params[p].hostType, arrays.value(p, 0), arrays.length(p, 0), arrays.valueSizes[p], false) != SQLDBC_OK) {
+            setTclError(interp, stmt->error());
+            return TCL_ERROR;
+        }
+    }
+    if (prepstmt()->execute() != SQLDBC_OK) {
+        setTclError(interp, stmt->error());
+        return TCL_ERROR;
+    }
+    addSerialRange(numRows);
+    return TCL_OK;
+}
+
+int SdbPrepStmt::executeChunk(Tcl_Interp* interp, Tcl_Obj* const rows[], int numRows, int firstRowNo, Tcl_Obj* rowStatus)
+{
+    size_t numParams = params.size();
+
+    std::vector<Tcl_Obj*> args(numRows * numParams);
+    ParamArrays           arrays(numParams);
+    for (size_t p = 0; p < numParams; p++) {
+        arrays.valueSizes[p] = params[p].isVarChar() ? 1 : params[p].getValueSize();
+    }
+
+    int numHeld = 0;  // rows which arguments are preserved
+    int rc      = TCL_ERROR;
+
+    // Arguments of each row are put into the parameters order, and the longest string of
+    // each variable length parameter defines the size of its array elements. Arguments are
+    // preserved as the conversion of one row might shimmer the list of another.
+    for (int r = 0; r < numRows; r++) {
+        int       argc;
+        Tcl_Obj** argv;
+        Tcl_Obj** rowArgs = args.data() + r * numParams;
+        if (Tcl_ListObjGetElements(interp, rows[r], &argc, &argv) != TCL_OK || orderArgs(interp, argc, argv, rowArgs) != TCL_OK) {
+            Tcl_AppendObjToErrorInfo(interp, Tcl_ObjPrintf("\n    (argument row %d)", firstRowNo + r));
+            goto Exit;
+        }
+        for (size_t p = 0; p < numParams; p++) {
+            Tcl_IncrRefCount(rowArgs[p]);
+            if (params[p].isVarChar()) {
+                int len;
+                if (params[p].hostType == SQLDBC_HOSTTYPE_BINARY) {
+                    Tcl_GetByteArrayFromObj(rowArgs[p], &len);
+                } else {
+                    Tcl_GetStringFromObj(rowArgs[p], &len);
+                }
+                arrays.valueSizes[p] = std::max(arrays.valueSizes[p], (SQLDBC_Length) len);
+            }
+        }
+        ++numHeld;
+    }
+
+    if (arrays.alloc(interp, numRows) != TCL_OK) {
+        goto Exit;
+    }
+    for (int r = 0; r < numRows; r++) {
+        for (size_t p = 0; p < numParams; p++) {
+            if (params[p].copyValue(interp, args[r * numParams + p], p + 1, arrays.value(p, r), arrays.length(p, r), arrays.valueSizes[p]) != TCL_OK) {
+                Tcl_AppendObjToErrorInfo(interp, Tcl_ObjPrintf("\n    (argument row %d)", firstRowNo + r));
+                goto Exit;
+            }
+        }
+    }
+    if (executeArrays(interp, arrays, numRows) != TCL_OK) {
+        goto Exit;
+    }
+    {
+        const SQLDBC_Int4* rowStats = stmt->getRowStatus();
+        for (int r = 0; r < numRows; r++) {
+            Tcl_ListObjAppendElement(nullptr, rowStatus, Tcl_NewIntObj(rowStats[r]));
+        }
+    }
+    rc = TCL_OK;
+
+Exit:
+    for (int i = 0; i < numHeld * (int) numParams; i++) {
+        Tcl_DecrRefCount(args[i]);
+    }
+    return rc;
+}
+
+int SdbPrepStmt::executeMany(Tcl_Interp* interp, Tcl_Obj* rowsObj, int batchSize)
+{
+    clearResults();
+
+    if (checkInputOnly(interp) != TCL_OK) {
+        return TCL_ERROR;
+    }
+
+    int       numRows;
+    Tcl_Obj** rows;
+    if (Tcl_ListObjGetElements(interp, rowsObj, &numRows, &rows) != TCL_OK) {
+        return TCL_ERROR;
+    }
+
+    Tcl_Obj* rowStatus = Tcl_NewListObj(0, nullptr);
+    Tcl_IncrRefCount(rowStatus);
+
+    int rc = TCL_OK;
+    for (int rowNo = 0; rowNo < numRows && rc == TCL_OK; rowNo += batchSize) {
+        rc = executeChunk(interp, rows + rowNo, std::min(batchSize, numRows - rowNo), rowNo, rowStatus);
+    }
+    // array bindings reference freed buffers
+    prepstmt()->clearParameters();
+    prepstmt()->setBatchSize(1);
+    bindInBuffers();
+
+    if (rc == TCL_OK) {
+        Tcl_SetObjResult(interp, rowStatus);
+    }
+    Tcl_DecrRefCount(rowStatus);
+    return rc;
+}
+
+int SdbPrepStmt::loadChunk(Tcl_Interp* interp, const std::string& text, const std::vector<FieldRef>& fields, int numRows, int* numRejected)
+{
+    size_t      numParams = params.size();
+    ParamArrays arrays(numParams);
+    for (size_t p = 0; p < numParams; p++) {
+        arrays.valueSizes[p] = params[p].isVarChar() ? 1 : params[p].getValueSize();
+    }
+    for (size_t f = 0; f < fields.size(); f++) {
+        size_t p = f % numParams;
+        if (params[p].isVarChar()) {
+            arrays.valueSizes[p] = std::max(arrays.valueSizes[p], (SQLDBC_Length) fields[f].length);
+        }
+    }
+    // Fields longer than the declared parameter length are rejected, so they do not need space
+    for (size_t p = 0; p < numParams; p++) {
+        if (params[p].isVarChar() && params[p].hasInBuffer()) {
+            arrays.valueSizes[p] = std::min(arrays.valueSizes[p], params[p].inBufferLength);
+        }
+    }
+    if (arrays.alloc(interp, numRows) != TCL_OK) {
+        return TCL_ERROR;
+    }
+
+    // Rejected records do not take array rows, so the accepted ones are packed together
+    int row = 0;
+    for (int r = 0; r < numRows; r++) {
+        const FieldRef* recordFields = fields.data() + r * numParams;
+
+        size_t p = 0;
+        for (; p < numParams; p++) {
+            const FieldRef& field = recordFields[p];
+            if (field.isNull) {
+                *arrays.length(p, row) = SQLDBC_NULL_DATA;
+            } else if (!params[p].fitsLength(text.data() + field.offset, field.length)) {
+                break;
+            } else if (params[p].copyText(interp, text.data() + field.offset, field.length, p + 1, arrays.value(p, row), arrays.length(p, row), arrays.valueSizes[p]) != TCL_OK) {
+                break;
+            }
+        }
+        if (p < numParams) {
+            Tcl_ResetResult(interp);
+            ++*numRejected;
+        } else {
+            ++row;
+        }
+    }
+
+    if (row > 0 && executeArrays(interp, arrays, row) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    if (stmt->getConnection()->commit() != SQLDBC_OK) {
+        setTclError(interp, stmt->getConnection()->error());
+        return TCL_ERROR;
+    }
+    return TCL_OK;
+}
+
+int SdbPrepStmt::load(Tcl_Interp* interp, Tcl_Channel chan, const LoadFormat& format, int batchSize)
+{
+    clearResults();
+
+    if (checkInputOnly(interp) != TCL_OK) {
+        return TCL_ERROR;
+    }
+
+    size_t       numParams = params.size();
+    RecordReader reader(chan, format);
+
+    std::string           text;
+    std::vector<FieldRef> fields;
+
+    int numLoaded   = 0;
+    int numRejected = 0;
+    int rc          = TCL_OK;
+    for (bool isEof = false; !isEof && rc == TCL_OK;) {
+        text.clear();
+        fields.clear();
+
+        int numRows = 0;
+        while (numRows < batchSize) {
+            size_t textSize   = text.size();
+            size_t fieldCount = fields.size();
+
+            int res = reader.read(interp, text, fields);
+            if (res <= 0) {
+                isEof = (res == 0);
+                rc    = (res == 0 ? TCL_OK : TCL_ERROR);
+                break;
+            }
+            if (fields.size() - fieldCount != numParams) {
+                text.resize(textSize);
+                fields.resize(fieldCount);
+                ++numRejected;
+                continue;
+            }
+            ++numRows;
+        }
+        if (rc == TCL_OK && numRows > 0) {
+            int batchRejected = 0;
+            rc = loadChunk(interp, text, fields, numRows, &batchRejected);
+            if (rc == TCL_OK) {
+                numLoaded += numRows - batchRejected;
+                numRejected += batchRejected;
+            }
+        }
+    }
+    // array bindings reference freed buffers
+    prepstmt()->clearParameters();
+    prepstmt()->setBatchSize(1);
+    bindInBuffers();
+
+    if (rc != TCL_OK) {
+        Tcl_AppendObjToErrorInfo(interp, Tcl_ObjPrintf("\n    (%d records loaded)", numLoaded));
+        return TCL_ERROR;
+    }
+
+    Tcl_Obj* items[] = {TCL_STR(loaded), Tcl_NewIntObj(numLoaded), TCL_STR(rejected), Tcl_NewIntObj(numRejected)};
+    Tcl_SetObjResult(interp, Tcl_NewListObj(4, items));
+    return TCL_OK;
+}
+
 // ------------------------------------------------------------------------------------------------
 
 static void freeIntRep (Tcl_Obj* obj)
 {
     SdbStmt* stmt = (SdbStmt*) obj->internalRep.otherValuePtr;
-    stmt->release();
+    stmt->detachHandle();
     obj->internalRep.otherValuePtr = nullptr;
 }
 
@@ -893,8 +2324,9 @@ static void dupIntRep (Tcl_Obj* src, Tcl_Obj* dst)
 {
     SdbStmt* stmt = (SdbStmt*) (dst->internalRep.otherValuePtr = src->internalRep.otherValuePtr);
     if (stmt) {
-        stmt->preserve();
+        stmt->attachHandle();
     }
+    dst->typePtr = src->typePtr;
 }
 
 Tcl_ObjType sdbStmtType = {
@@ -909,13 +2341,23 @@ Tcl_ObjType sdbPrepStmtType = {
     .dupIntRepProc  = dupIntRep,
 };
 
+/**
+ * SQL text which internal representation is the prepare stamp of the statement that was prepared
+ * for it. The stamp does not reference the statement, so the statement cache alone decides how
+ * long the statement stays open. String representation of these objects is never invalidated,
+ * thus they do not need updateStringProc.
+ */
+Tcl_ObjType sdbSqlType = {
+    .name = (char*) "sdbsql",
+};
+
 Tcl_Obj* Tcl_NewSdbStmtObj (SdbStmt* stmt)
 {
     Tcl_Obj* obj = Tcl_NewObj();
     obj->typePtr = &sdbStmtType;
 
     obj->internalRep.otherValuePtr = stmt;
-    stmt->preserve();
+    stmt->attachHandle();
     return obj;
 }
 
@@ -925,10 +2367,29 @@ Tcl_Obj* Tcl_NewSdbPrepStmtObj (SdbStmt* stmt)
     obj->typePtr = &sdbPrepStmtType;
 
     obj->internalRep.otherValuePtr = stmt;
-    stmt->preserve();
+    stmt->attachHandle();
     return obj;
 }
 
+bool Tcl_GetSdbSqlStamp (Tcl_Obj* sql, unsigned long* stampPtr)
+{
+    if (sql->typePtr != &sdbSqlType) {
+        return false;
+    }
+    *stampPtr = sql->internalRep.ptrAndLongRep.value;
+    return true;
+}
+
+void Tcl_SetSdbSqlStamp (Tcl_Obj* sql, SdbPrepStmt* stmt)
+{
+    // the string representation is kept as it is the SQL text
+    Tcl_GetString(sql);
+    TclFreeIntRep(sql);
+    sql->internalRep.ptrAndLongRep.ptr   = nullptr;
+    sql->internalRep.ptrAndLongRep.value = stmt->getPrepareStamp();
+    sql->typePtr                         = &sdbSqlType;
+}
+
 int Tcl_GetSdbStmtFromObj (Tcl_Obj* obj, SdbStmt** stmtPtr)
 {
     if (obj->typePtr != &sdbStmtType && obj->typePtr != &sdbPrepStmtType) {
@@ -1,11 +1,62 @@
 #pragma once
 
 #include "sdbtcl.h"
+#include "sdbload.h"
+#include "sdbsource.h"
 #include <vector>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 
 class SdbConn;
+class SdbStmt;
+struct Column;
 extern Tcl_ObjType sdbStmtType;
 extern Tcl_ObjType sdbPrepStmtType;
+extern Tcl_ObjType sdbSqlType;
+
+/**
+ * Representation of DATE, TIME and TIMESTAMP values in TCL.
+ */
+enum DateTimeMode {
+    DateTimeAsString,      /// strings formatted by the database
+    DateTimeAsEpoch,       /// seconds since 1970-01-01 00:00:00 UTC
+    DateTimeAsEpochMicros  /// microseconds since 1970-01-01 00:00:00 UTC
+};
+
+/**
+ * Representation of FIXED values that cannot be represented exactly by TCL integers or doubles.
+ */
+enum DecimalMode {
+    DecimalAsNative,  /// integers, doubles for FIXED with scale, or strings for FIXED with precision over 15 digits
+    DecimalAsScaled   /// integers scaled by 10^scale
+};
+
+/**
+ * Converts column value that was fetched into the column buffer into a TCL object.
+ */
+typedef Tcl_Obj* (*ValueDecoder)(SdbStmt& stmt, const Column& col, void* data, SQLDBC_Length len);
+
+/**
+ * Shared TCL strings for the repeating values of a column.
+ */
+class InternTable {
+    std::unordered_map<std::string_view, Tcl_Obj*> values;  /// keys reference bytes of the interned strings
+
+public:
+    /**
+     * Maximum number of distinct values that are interned per column. Values that are seen
+     * after the table is full are returned as new unshared objects.
+     */
+    static const size_t MAX_SIZE = 1024;
+
+    ~InternTable();
+
+    /**
+     * Returns shared TCL string for the given UTF-8 bytes.
+     */
+    Tcl_Obj* get (const char* str, SQLDBC_Length len);
+};
 
 struct Column {
     Tcl_Obj*        label;
@@ -15,11 +66,16 @@ struct Column {
     SQLDBC_Int2     byteLength;
     SQLDBC_SQLType  sqlType;
     SQLDBC_HostType hostType;
+    SQLDBC_Length   valueSize;  /// size of the buffer that can hold a single value of this column
+    size_t          offset;     /// offset of this column's value(s) in the row buffer
+    ValueDecoder    decode;     /// converter of the fetched values that is specialized for the host type
+    InternTable*    interned;   /// shared values of the column when it is interned
 
-    Column(SQLDBC_ResultSetMetaData* info, int columnNo);
+    Column(SQLDBC_ResultSetMetaData* info, int columnNo, DateTimeMode dateTimeMode, DecimalMode decimalMode);
     ~Column()
     {
         if (label) Tcl_DecrRefCount(label);
+        if (interned) delete interned;
     }
 };
 
@@ -29,8 +85,18 @@ struct ResultSetConfig {
     Tcl_Obj* name;
     Tcl_Obj* maxRows;
     Tcl_Obj* fetchSize;
+    Tcl_Obj* intern;
+    Tcl_Obj* dateTime;
+    Tcl_Obj* decimal;
+    Tcl_Obj* lazy;
+    Tcl_Obj* lobInline;
+
+    ResultSetConfig () : type(nullptr), concurrency(nullptr), name(nullptr), maxRows(nullptr), fetchSize(nullptr), intern(nullptr), dateTime(nullptr), decimal(nullptr), lazy(nullptr), lobInline(nullptr) {}
 
-    ResultSetConfig () : type(nullptr), concurrency(nullptr), name(nullptr), maxRows(nullptr), fetchSize(nullptr) {}
+    /**
+     * Returns true if any of the options was set.
+     */
+    bool hasOptions () { return type || concurrency || name || maxRows || fetchSize || intern || dateTime || decimal || lazy || lobInline; }
 
     /**
      * Collects statement result set options.
@@ -41,10 +107,25 @@ struct ResultSetConfig {
      *  - resultsettype   : Sets the type of a result set: "FORWARD ONLY", "SCROLL SENSITIVE", or "SCROLL INSENSITIVE"
      *  - concurrencytype : Sets the type of the result set concurrency: "READ ONLY", "UPDATABLE", or "UPDATABLE LOCK OPTIMISTIC"
      *  - fetchsize       : Sets the desired fetch size. If it is 1, updates using CURRENT OF become possible
+     *  - intern          : Sets the list of labels of the columns whose fetched values are shared
+     *  - datetime        : Sets the representation of DATE, TIME and TIMESTAMP values: "string", "epoch", or "epochmicros"
+     *  - decimal         : Sets the representation of FIXED values with scale or with precision over 15 digits: "native" or "scaled"
+     *  - lazy            : Sets whether scaled decimals with over 18 digits are converted into TCL values only when they are used
+     *  - lobinline       : Sets the length below which LOB values are fetched as strings or byte arrays instead of LOB handles
      */
     int init (Tcl_Interp* interp, int* idxPtr, int objc, Tcl_Obj* const objv[]);
 };
 
+/**
+ * Serial keys that were generated by one execution of the statement.
+ */
+struct SerialRange {
+    Tcl_WideInt first;
+    Tcl_WideInt last;
+    Tcl_WideInt numRows;  /// number of inserted rows or -1 if it is not known
+    bool        isKnown;  /// false if the keys were generated, but could not be retrieved
+};
+
 class SdbStmt {
 protected:
     SQLDBC_Statement*         stmt;
@@ -53,9 +134,68 @@ protected:
     std::vector<Column>       cols;
     SdbConn*                  conn;
     int                       refCount;
+    int                       handleCount;    /// number of TCL statement handles that reference the statement
     SQLDBC_Int2               fetchSize;
+    Tcl_Obj*                  internLabels;   /// labels of the columns which values are interned
+    DateTimeMode              dateTimeMode;   /// representation of the DATE, TIME and TIMESTAMP values
+    DecimalMode               decimalMode;    /// representation of the FIXED values
+    bool                      lazyCells;      /// whether scaled decimals with over 18 digits are converted only when they are used
+    SQLDBC_Length             lobInlineSize;  /// LOBs shorter than this are fetched as values, 0 when all LOBs are fetched as handles
+    bool                      isConfigured;   /// result set options were changed from their defaults
+    size_t                    rowSize;        /// size of all (aligned) column buffers of a single row
+    char*                     rowData;        /// column buffers of a single row that are reused by row by row fetches
+    char*                     rowSetData;     /// column-wise bound buffers of the row set
+    SQLDBC_Length*            rowSetLengths;  /// length indicators of the row set values
+    SQLDBC_UInt4              rowSetSize;     /// number of rows in the bound row set, 0 when columns are not bound
+    std::vector<SerialRange>  serialRanges;   /// keys generated by the batches of the last bulk execution
+
+    SdbStmt(SdbConn* conn, int refCount) : conn(conn), rset(nullptr), rsetInfo(nullptr), refCount(refCount), handleCount(0), fetchSize(-1), internLabels(nullptr), dateTimeMode(DateTimeAsString), decimalMode(DecimalAsNative), lazyCells(false), lobInlineSize(0), isConfigured(false), rowSize(0), rowData(nullptr), rowSetData(nullptr), rowSetLengths(nullptr), rowSetSize(0) {}
+
+    /**
+     * Binds column buffers for the row set of the requested size.
+     */
+    int bindRowSet (Tcl_Interp* interp, SQLDBC_UInt4 numRows);
+
+    /**
+     * Binds columns to the row set buffers.
+     */
+    int bindRowSetColumns (Tcl_Interp* interp);
+
+    /**
+     * Unbinds row set buffers and restores the default single row fetching.
+     */
+    void unbindRowSet ();
+
+    /**
+     * Releases row set buffers.
+     */
+    void freeRowSet ();
+
+    /**
+     * Releases row and row set buffers of the current result set.
+     */
+    void freeResultBuffers ();
+
+    /**
+     * Fetches the next row set of the requested size.
+     */
+    int fetchRowSet (Tcl_Interp* interp, SQLDBC_UInt4 numRows, int* numFetched);
+
+    /**
+     * Returns value of the column in the specified row of the fetched row set or `nullObj` if
+     * the value is NULL. Returns NULL, and sets TCL error, if the value cannot be retrieved.
+     */
+    Tcl_Obj* getRowSetValue (Tcl_Interp* interp, int colIdx, SQLDBC_UInt4 row, Tcl_Obj* nullObj);
 
-    SdbStmt(SdbConn* conn, int refCount) : conn(conn), rset(nullptr), rsetInfo(nullptr), refCount(refCount), fetchSize(-1) {}
+    /**
+     * Switches columns, which labels are listed in the intern labels, to the shared value decoder.
+     */
+    void internColumns ();
+
+    /**
+     * Creates TCL object for the column value that was fetched into the provided buffer.
+     */
+    Tcl_Obj* newValueObj (const Column& col, void* data, SQLDBC_Length len);
 
 public:
     SdbStmt(SdbConn* conn);
@@ -69,6 +209,49 @@ public:
         }
     }
 
+    /**
+     * Preserves the statement for a TCL statement handle.
+     */
+    void attachHandle ()
+    {
+        ++handleCount;
+        preserve();
+    }
+
+    /**
+     * Releases the statement when the TCL statement handle is freed.
+     */
+    void detachHandle ()
+    {
+        --handleCount;
+        release();
+    }
+
+    /**
+     * Returns true if the statement is referenced by TCL statement handles, and thus might be in use.
+     */
+    bool hasHandles () { return handleCount > 0; }
+
+    /**
+     * Returns true if result set options of the statement were changed, so it cannot be shared.
+     */
+    bool hasOptions () { return isConfigured; }
+
+    /**
+     * Returns the connection of the statement or NULL if the connection has been closed.
+     */
+    SdbConn* getConnection () { return conn; }
+
+    /**
+     * Returns the representation of the DATE, TIME and TIMESTAMP values.
+     */
+    DateTimeMode getDateTimeMode () { return dateTimeMode; }
+
+    /**
+     * Returns the length below which LOB values are fetched inline.
+     */
+    SQLDBC_Length getLobInlineSize () { return lobInlineSize; }
+
     /**
      * Releases all database handles without destroying the object.
      *
@@ -115,6 +298,31 @@ public:
      */
     int setFetchSize (Tcl_Interp* interp, Tcl_Obj* size);
 
+    /**
+     * Sets the list of labels of the columns which fetched values should be interned.
+     */
+    int setInternLabels (Tcl_Interp* interp, Tcl_Obj* labels);
+
+    /**
+     * Sets the representation of the DATE, TIME and TIMESTAMP values.
+     */
+    int setDateTimeMode (Tcl_Interp* interp, Tcl_Obj* mode);
+
+    /**
+     * Sets the representation of the FIXED values.
+     */
+    int setDecimalMode (Tcl_Interp* interp, Tcl_Obj* mode);
+
+    /**
+     * Sets whether fetched values should be converted into TCL values only when they are used.
+     */
+    int setLazyCells (Tcl_Interp* interp, Tcl_Obj* isLazy);
+
+    /**
+     * Sets the length below which LOB values are fetched as strings or byte arrays.
+     */
+    int setLobInlineSize (Tcl_Interp* interp, Tcl_Obj* size);
+
     /**
      * Closes results of previous executions.
      */
@@ -167,6 +375,11 @@ public:
      */
     bool isQuery () { return stmt->isQuery(); }
 
+    /**
+     * Checks if the statement has an open result set.
+     */
+    bool hasResultSet () { return rset != nullptr; }
+
     /**
      * Returns the number of columns in the result set.
      */
@@ -178,9 +391,24 @@ public:
     int getRowNumber ();
 
     /**
-     * Retrieves the key that was inserted by the last insert operation.
+     * Retrieves the first and the last serial keys that were generated by the last execution.
+     * Returns SQLDBC_NO_DATA_FOUND if the execution has not generated any keys.
+     */
+    SQLDBC_Retcode getSerialRange (SerialRange& range);
+
+    /**
+     * Remembers keys that were generated by the execution of the batch, or that the batch keys
+     * could not be retrieved.
      */
-    int serial (Tcl_Interp* interp, bool last);
+    void addSerialRange (Tcl_WideInt numRows);
+
+    enum SerialKey { FirstKey, LastKey, AllKeys };
+
+    /**
+     * Retrieves the key that was inserted by the last insert operation or all the keys that
+     * were generated by the last (bulk) execution.
+     */
+    int serial (Tcl_Interp* interp, SerialKey which);
 
     /**
      * Returns a list of column names in the result set.
@@ -206,6 +434,31 @@ public:
      */
     int getRowData (Tcl_Interp* interp, Tcl_Obj* rowVar, Tcl_Obj* nullVar, bool returnAsArray);
 
+    /**
+     * Fetches up to the specified number of the next rows into column buffers that are bound once
+     * for the entire row set. Saves rows as a list of row lists into `rowsVar` and the null indicators,
+     * if requested, into `nullsVar`.
+     *
+     * Sets TCL result to the number of fetched rows, which is 0 when there are no more rows.
+     */
+    int fetchRows (Tcl_Interp* interp, SQLDBC_UInt4 numRows, Tcl_Obj* rowsVar, Tcl_Obj* nullsVar);
+
+    /**
+     * Number of rows in the row sets that are used to fetch columns.
+     */
+    static const SQLDBC_UInt4 COLUMNS_ROW_SET_SIZE = 256;
+
+    /**
+     * Fetches the remaining rows, or up to `limit` rows if it is positive, and saves them column-wise
+     * as a dictionary that maps column labels to lists of column values into `colsVar`. If `nullsVar`
+     * is provided, saves into it a dictionary that maps column labels to null bitmaps - byte arrays
+     * where bit N (counting from the least significant bit of the first byte) is set when the value
+     * in row N is NULL.
+     *
+     * Sets TCL result to the number of fetched rows.
+     */
+    int fetchColumns (Tcl_Interp* interp, int limit, Tcl_Obj* colsVar, Tcl_Obj* nullsVar);
+
     //-------
 
     /**
@@ -218,6 +471,27 @@ public:
      * ```
      */
     int batch (Tcl_Interp* interp, int argc, Tcl_Obj* const argv[]);
+
+    /**
+     * Default number of argument rows that are sent to the server in a single round trip by `executemany`.
+     */
+    static const int DEFAULT_BATCH_SIZE = 1000;
+
+    /**
+     * Executes the prepared statement once for each list of arguments in the rows list.
+     * Returns (as an interpreter result) a list of row statuses.
+     *
+     * Only prepared statements can be executed this way.
+     */
+    virtual int executeMany (Tcl_Interp* interp, Tcl_Obj* rows, int batchSize);
+
+    /**
+     * Loads delimited text records from the channel using the prepared statement.
+     * Returns (as an interpreter result) a dictionary with the number of loaded and rejected records.
+     *
+     * Only prepared statements can load data.
+     */
+    virtual int load (Tcl_Interp* interp, Tcl_Channel chan, const LoadFormat& format, int batchSize);
 };
 
 struct Param {
@@ -226,20 +500,33 @@ struct Param {
         double      doubleValue;
         Tcl_WideInt wideIntValue;
         int         intValue;
+
+        SQL_DATE_STRUCT      dateValue;
+        SQL_TIME_STRUCT      timeValue;
+        SQL_TIMESTAMP_STRUCT timestampValue;
+
+        unsigned char decimalValue[MAX_DECIMAL_SIZE];
     } outData;
     SQLDBC_Length   dataLength;
+    SQLDBC_Length   inBufferLength;  /// size of the input buffer or 0 if IN values are bound directly
+    Tcl_Obj*        boundArg;        /// argument which value is in the input buffer
+    bool            isBound;         /// the input buffer is bound to the parameter
+    SdbLobSource*   lobSource;       /// source of the LONG value that is sent when the statement is executed
     Tcl_Obj*        outVarName;
-    Tcl_Obj*        name;  /// :NAME of the parameter or NULL if the ? (positional parameter) was used
+    Tcl_Obj*        outVarKey;  /// element of the outVarName array that receives the output (owned) or NULL if outVarName is a scalar
+    Tcl_Obj*        name;       /// :NAME of the parameter or NULL if the ? (positional parameter) was used
+    Tcl_Obj*        key;        /// NAME without the colon that is used to find the argument in a dict or an array
     SQLDBC_Int2     length;
     SQLDBC_Int2     precision;
     SQLDBC_Int2     scale;
     SQLDBC_Int2     byteLength;
     SQLDBC_SQLType  sqlType;
     SQLDBC_HostType hostType;
+    DateTimeMode    dateTimeMode;
 
     SQLDBC_ParameterMetaData::ParameterMode inOutMode;
 
-    Param(SQLDBC_ParameterMetaData* info, int paramNo);
+    Param(SQLDBC_ParameterMetaData* info, int paramNo, DateTimeMode dateTimeMode, DecimalMode decimalMode);
     ~Param();
 
     Param& operator= (const Param&) = delete;
@@ -247,27 +534,178 @@ struct Param {
     bool isIn () { return inOutMode != SQLDBC_ParameterMetaData::ParameterMode::parameterModeOut; }
     bool isOut () { return inOutMode == SQLDBC_ParameterMetaData::ParameterMode::parameterModeOut || inOutMode == SQLDBC_ParameterMetaData::ParameterMode::parameterModeInOut; }
     bool isVarChar () { return hostType == SQLDBC_HOSTTYPE_BINARY || hostType == SQLDBC_HOSTTYPE_UTF8; }
+    bool isDateTime () { return hostType == SQLDBC_HOSTTYPE_ODBCDATE || hostType == SQLDBC_HOSTTYPE_ODBCTIME || hostType == SQLDBC_HOSTTYPE_ODBCTIMESTAMP; }
+    bool hasInBuffer () { return inBufferLength > 0; }
+
+    SQLDBC_Length getValueSize ();
+
+    /**
+     * Returns false if the text is longer than the declared length of a character or binary parameter.
+     */
+    bool fitsLength (const char* text, int len);
 
     bool checkAndSetNull (Tcl_Obj* arg);
+    int copyValue (Tcl_Interp* interp, Tcl_Obj* arg, int idx, void* data, SQLDBC_Length* lengthPtr, SQLDBC_Length bufferLength);
+    int copyText (Tcl_Interp* interp, const char* text, int len, int idx, void* data, SQLDBC_Length* lengthPtr, SQLDBC_Length bufferLength);
     int copyIntoOutDataBuffer (Tcl_Interp* interp, Tcl_Obj* arg, int idx);
     void bindOutDataBufferTo (SQLDBC_PreparedStatement* stmt, int idx);
     int bindInTo (SQLDBC_PreparedStatement* stmt, int idx, Tcl_Interp* interp, Tcl_Obj* arg);
 
+    /**
+     * Binds the LONG parameter to the source that will provide its value during execution.
+     */
+    int bindSourceTo (SQLDBC_PreparedStatement* stmt, int idx, Tcl_Interp* interp, Tcl_Obj* arg);
+
+    /**
+     * Releases the LOB source that was bound to the parameter.
+     */
+    void forgetLobSource ();
+
+    /**
+     * Binds the input buffer to the parameter.
+     */
+    void bindInBufferTo (SQLDBC_PreparedStatement* stmt, int idx);
+
+    /**
+     * Copies the argument into the input buffer unless it is already there. Parameters without
+     * input buffer, and date-time parameters with textual arguments, are bound to the argument
+     * directly.
+     */
+    int setInput (SQLDBC_PreparedStatement* stmt, int idx, Tcl_Interp* interp, Tcl_Obj* arg);
+
+    /**
+     * Forgets the argument, so the next one is copied into the input buffer even if it is the same.
+     */
+    void forgetBoundArg ();
+
     Tcl_Obj* getOutObj ();
 };
 
+/**
+ * Column-wise arrays of parameter values for the batch execution.
+ */
+struct ParamArrays {
+    std::vector<SQLDBC_Length> valueSizes;  /// sizes of array elements
+    std::vector<size_t>        offsets;     /// offsets of parameter arrays in the data buffer
+    char*                      data;
+    SQLDBC_Length*             lengths;
+    int                        numRows;
+
+    ParamArrays(size_t numParams) : valueSizes(numParams), offsets(numParams), data(nullptr), lengths(nullptr), numRows(0) {}
+    ~ParamArrays();
+
+    ParamArrays& operator= (const ParamArrays&) = delete;
+
+    /**
+     * Allocates arrays for the given number of rows.
+     */
+    int alloc (Tcl_Interp* interp, int numRows);
+
+    void* value (size_t paramIdx, int row) { return data + offsets[paramIdx] + row * valueSizes[paramIdx]; }
+    SQLDBC_Length* length (size_t paramIdx, int row) { return lengths + paramIdx * numRows + row; }
+};
+
 class SdbPrepStmt : public SdbStmt {
-    std::vector<Param> params;
+    std::vector<Param>                                params;
+    std::unordered_map<std::string, std::vector<int>> paramIndex;    /// upper case parameter names to indexes of the parameters with that name
+    unsigned long                                     prepareStamp;  /// identifies the prepared SQL in parameter name and SQL text objects
+    bool                                              isInCache;     /// the statement is kept by the statement cache of the connection
 
     SQLDBC_PreparedStatement* prepstmt () { return (SQLDBC_PreparedStatement*) stmt; }
 
     int copyOutput (Tcl_Interp* interp);
 
+    /**
+     * Checks that the number of arguments matches the number of parameters.
+     */
+    int checkArgCount (Tcl_Interp* interp, int argc);
+
+    /**
+     * Returns indexes of the parameters with the given name or NULL if the statement does not have it.
+     * The found indexes are remembered by the name object, so the repeated lookups are not needed.
+     */
+    const std::vector<int>* findParam (Tcl_Obj* name);
+
+    /**
+     * Returns indexes of the parameters which name without the colon matches the dict key
+     * regardless of its case or NULL if the statement does not have such parameter.
+     */
+    const std::vector<int>* findParamByKey (Tcl_Obj* key);
+
+    /**
+     * Sends the content of the LOB sources to the parameters that the execution needs.
+     */
+    int putLobSources (Tcl_Interp* interp);
+
+    /**
+     * Releases the LOB sources of the last execution, so their files and channels are not kept open.
+     */
+    void forgetLobSources ();
+
+    /**
+     * Binds input buffers of the parameters that have them.
+     */
+    void bindInBuffers ();
+
+    /**
+     * Binds the argument to the parameter. For OUT parameters the argument is the name of the
+     * variable, or the array if the key of its element is provided, that receives the output.
+     */
+    int bindArg (Tcl_Interp* interp, int idx, Tcl_Obj* arg, Tcl_Obj* key = nullptr);
+
+    /**
+     * Binds values of the dict or elements of the array, which keys are the parameter names
+     * without the colon in any case, to the named parameters.
+     */
+    int bindFrom (Tcl_Interp* interp, Tcl_Obj* source, Tcl_Obj* arg);
+
+    /**
+     * Puts arguments into the parameters order.
+     */
+    int orderArgs (Tcl_Interp* interp, int argc, Tcl_Obj* const argv[], Tcl_Obj* args[]);
+
+    /**
+     * Binds arrays of arguments of the given rows and executes them in a single round trip.
+     * Appends row statuses to the rowStatus list.
+     */
+    int executeChunk (Tcl_Interp* interp, Tcl_Obj* const rows[], int numRows, int firstRowNo, Tcl_Obj* rowStatus);
+
+    /**
+     * Binds parameter arrays and executes the first numRows rows of them.
+     */
+    int executeArrays (Tcl_Interp* interp, ParamArrays& arrays, int numRows);
+
+    /**
+     * Returns an error if the statement has output parameters, which cannot be bound as arrays.
+     */
+    int checkInputOnly (Tcl_Interp* interp);
+
+    /**
+     * Converts the fields of the batch records into parameter arrays and executes them.
+     * Records which fields cannot be converted are skipped and added to numRejected.
+     */
+    int loadChunk (Tcl_Interp* interp, const std::string& text, const std::vector<FieldRef>& fields, int numRows, int* numRejected);
+
 public:
     SdbPrepStmt(SdbConn* conn);
 
     void releaseDatabaseHandles () override;
 
+    /**
+     * Returns true if the statement is kept by the statement cache of its connection.
+     */
+    bool isCached () { return isInCache; }
+
+    /**
+     * Marks the statement as added to or evicted from the statement cache.
+     */
+    void setCached (bool isCached) { isInCache = isCached; }
+
+    /**
+     * Returns the stamp that identifies this prepared statement within the process.
+     */
+    unsigned long getPrepareStamp () { return prepareStamp; }
+
     /**
      * Prepares a given SQL statement for execution.
      *
@@ -323,6 +761,38 @@ public:
      * ```
      */
     int execute (Tcl_Interp* interp, int idx, int argc, Tcl_Obj* const argv[], ResultSetConfig& config) override;
+
+    /**
+     * Executes a prepared SQL statement for each list of arguments.
+     *
+     * Arguments are bound as column-wise arrays and sent to the server in batches of
+     * batchSize rows.
+     *
+     * ```tcl
+     * set stmt [db prepare "INSERT INTO city (zip, name, state) VALUES (:ZIP, :NAME, :STATE)"]
+     * set rowStatus [db executemany $stmt {
+     *   {:ZIP 60601 :NAME Chicago :STATE IL}
+     *   {:ZIP 10019 :NAME "New York" :STATE NY}
+     * }]
+     * ```
+     */
+    int executeMany (Tcl_Interp* interp, Tcl_Obj* rows, int batchSize) override;
+
+    /**
+     * Loads delimited text records from the channel.
+     *
+     * Fields of each record are converted into the parameters, in order, and records are inserted
+     * in batches of batchSize rows. The transaction is committed after each batch. Records that
+     * cannot be converted are skipped and counted as rejected.
+     *
+     * ```tcl
+     * set stmt [db prepare "INSERT INTO city (zip, name, state) VALUES (?, ?, ?)"]
+     * set chan [open cities.csv]
+     * set res [db load $stmt -channel $chan -format csv]
+     * close $chan
+     * ```
+     */
+    int load (Tcl_Interp* interp, Tcl_Channel chan, const LoadFormat& format, int batchSize) override;
 };
 
 /**
@@ -337,6 +807,18 @@ Tcl_Obj* Tcl_NewSdbStmtObj (SdbStmt* stmt);
  */
 int Tcl_GetSdbStmtFromObj (Tcl_Obj* obj, SdbStmt** stmtPtr);
 
+/**
+ * Returns true and the prepare stamp of the statement that was last prepared for the SQL text
+ * object. The stamp does not keep the statement alive, so it has to be looked up in the statement
+ * cache, which finds it only while the statement is still cached.
+ */
+bool Tcl_GetSdbSqlStamp (Tcl_Obj* sql, unsigned long* stampPtr);
+
+/**
+ * Remembers the prepare stamp of the cached statement in the SQL text object.
+ */
+void Tcl_SetSdbSqlStamp (Tcl_Obj* sql, SdbPrepStmt* stmt);
+
 /**
  * Statements subcommands multiplexor.
  */
@@ -1,4 +1,5 @@
 #include "sdbtcl.h"
+#include <tclTomMath.h>
 
 #include <memory>
 #include <cstring>
@@ -91,6 +92,9 @@ extern "C" DLLEXPORT int Sdbtcl_Init (Tcl_Interp* interp)
     if (Tcl_InitStubs(interp, TCL_VERSION, 0) == NULL) {
         return TCL_ERROR;
     }
+    if (Tcl_TomMath_InitStubs(interp, TCL_VERSION) == NULL) {
+        return TCL_ERROR;
+    }
 #endif
     char errorText[256];
 
@@ -1,8 +1,57 @@
 #include "sdbutil.h"
+#include <tclTomMath.h>
 #include <cctype>
 #include <cstring>
 
 static Tcl_Obj* tclStrings[NUM_TCL_LIT_STRINGS];
+static Tcl_Obj* tclValues[NUM_TCL_VALUES];
+
+static const NamedValue SQL_TYPES[] = {
+    {"FIXED",           5,   SQLDBC_SQLTYPE_FIXED},
+    {"FLOAT",           5,   SQLDBC_SQLTYPE_FLOAT},
+    {"CHAR ASCII",      10,  SQLDBC_SQLTYPE_CHA},
+    {"CHAR EBCDIC",     11,  SQLDBC_SQLTYPE_CHE},
+    {"CHAR BYTE",       9,   SQLDBC_SQLTYPE_CHB},
+    {"ROWID",           5,   SQLDBC_SQLTYPE_ROWID},
+    {"CLOB ASCII",      10,  SQLDBC_SQLTYPE_STRA},
+    {"LONG EBCDIC",     11,  SQLDBC_SQLTYPE_STRE},
+    {"BLOB",            4,   SQLDBC_SQLTYPE_STRB},
+    {"STRDB",           5,   SQLDBC_SQLTYPE_STRDB},
+    {"DATE",            4,   SQLDBC_SQLTYPE_DATE},
+    {"TIME",            4,   SQLDBC_SQLTYPE_TIME},
+    {"VFLOAT",          6,   SQLDBC_SQLTYPE_VFLOAT},
+    {"TIMESTAMP",       9,   SQLDBC_SQLTYPE_TIMESTAMP},
+    {"UNKNOWN",         7,   SQLDBC_SQLTYPE_UNKNOWN},
+    {"NUMBER",          6,   SQLDBC_SQLTYPE_NUMBER},
+    {"NONUMBER",        8,   SQLDBC_SQLTYPE_NONUMBER},
+    {"DURATION",        8,   SQLDBC_SQLTYPE_DURATION},
+    {"DBYTEEBCDIC",     11,  SQLDBC_SQLTYPE_DBYTEEBCDIC},
+    {"LONG ASCII",      10,  SQLDBC_SQLTYPE_LONGA},
+    {"LONG EBCDIC",     11,  SQLDBC_SQLTYPE_LONGE},
+    {"LONG BYTE",       9,   SQLDBC_SQLTYPE_LONGB},
+    {"LONGDB",          6,   SQLDBC_SQLTYPE_LONGDB},
+    {"BOOLEAN",         7,   SQLDBC_SQLTYPE_BOOLEAN},
+    {"CHAR UNICODE",    12,  SQLDBC_SQLTYPE_UNICODE},
+    {"DTFILLER1",       9,   SQLDBC_SQLTYPE_DTFILLER1},
+    {"DTFILLER2",       9,   SQLDBC_SQLTYPE_DTFILLER2},
+    {"VOID",            4,   SQLDBC_SQLTYPE_VOID},
+    {"DTFILLER4",       9,   SQLDBC_SQLTYPE_DTFILLER4},
+    {"SMALLINT",        8,   SQLDBC_SQLTYPE_SMALLINT},
+    {"INTEGER",         7,   SQLDBC_SQLTYPE_INTEGER},
+    {"VARCHAR ASCII",   13,  SQLDBC_SQLTYPE_VARCHARA},
+    {"VARCHAR EBCDIC",  14,  SQLDBC_SQLTYPE_VARCHARE},
+    {"VARCHAR BYTE",    12,  SQLDBC_SQLTYPE_VARCHARB},
+    {"CLOB UNICODE",    12,  SQLDBC_SQLTYPE_STRUNI},
+    {"LONG UNICODE",    12,  SQLDBC_SQLTYPE_LONGUNI},
+    {"VARCHAR UNICODE", 15,  SQLDBC_SQLTYPE_VARCHARUNI},
+    {"UDT",             3,   SQLDBC_SQLTYPE_UDT},
+    {"ABAPTABHANDLE",   13,  SQLDBC_SQLTYPE_ABAPTABHANDLE},
+    {"DWYDE",           5,   SQLDBC_SQLTYPE_DWYDE}
+};
+
+static const int NUM_SQL_TYPES = sizeof(SQL_TYPES) / sizeof(SQL_TYPES[0]);
+
+static Tcl_Obj* tclSqlTypeNames[NUM_SQL_TYPES];
 
 void strtoupper (const char* str, char* buff, int size)
 {
@@ -37,16 +86,257 @@ Tcl_Obj* getTclString (TclLit lit, const char* value)
     return *strPtr;
 }
 
-void releaseTclStrings ()
+Tcl_Obj* getTclValue (TclVal val)
 {
-    Tcl_Obj** strPtr = &tclStrings[0];
-    Tcl_Obj** endPtr = &tclStrings[NUM_TCL_LIT_STRINGS];
-    while (strPtr < endPtr) {
-        if (*strPtr != nullptr) {
-            Tcl_DecrRefCount(*strPtr);
-            *strPtr = nullptr;
+    Tcl_Obj** valPtr = &tclValues[val];
+    if (*valPtr == nullptr) {
+        switch (val) {
+            case falseValue: *valPtr = Tcl_NewBooleanObj(0); break;
+            case trueValue:  *valPtr = Tcl_NewBooleanObj(1); break;
+            default:         *valPtr = Tcl_NewObj(); break;
         }
+        Tcl_IncrRefCount(*valPtr);
+    }
+    return *valPtr;
+}
+
+Tcl_Obj* getTclSqlTypeName (SQLDBC_SQLType sqlType)
+{
+    if (sqlType < 0 || NUM_SQL_TYPES <= sqlType) {
+        sqlType = SQLDBC_SQLTYPE_UNKNOWN;
+    }
+    Tcl_Obj** strPtr = &tclSqlTypeNames[sqlType];
+    if (*strPtr == nullptr) {
+        Tcl_IncrRefCount(*strPtr = Tcl_NewStringObj(SQL_TYPES[sqlType].name, SQL_TYPES[sqlType].length));
     }
+    return *strPtr;
+}
+
+static const Tcl_WideInt SECONDS_PER_DAY = 86400;
+
+/**
+ * Returns the number of days since 1970-01-01 for a date in the proleptic Gregorian calendar.
+ */
+static Tcl_WideInt daysFromCivil (Tcl_WideInt year, unsigned month, unsigned day)
+{
+    year -= month <= 2;
+    Tcl_WideInt era = (year >= 0 ? year : year - 399) / 400;
+    unsigned    yoe = (unsigned) (year - era * 400);
+    unsigned    doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    unsigned    doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+/**
+ * Converts the number of days since 1970-01-01 into a date in the proleptic Gregorian calendar.
+ */
+static void civilFromDays (Tcl_WideInt days, SQL_DATE_STRUCT* date)
+{
+    days += 719468;
+    Tcl_WideInt era = (days >= 0 ? days : days - 146096) / 146097;
+    unsigned    doe = (unsigned) (days - era * 146097);
+    unsigned    yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned    doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned    mp  = (5 * doy + 2) / 153;
+    date->day   = doy - (153 * mp + 2) / 5 + 1;
+    date->month = mp < 10 ? mp + 3 : mp - 9;
+    date->year  = yoe + era * 400 + (date->month <= 2);
+}
+
+Tcl_WideInt dateTimeToEpoch (SQLDBC_HostType hostType, const void* data, Tcl_WideInt unitsPerSecond)
+{
+    switch (hostType) {
+        case SQLDBC_HOSTTYPE_ODBCDATE: {
+            const SQL_DATE_STRUCT* date = (const SQL_DATE_STRUCT*) data;
+            return daysFromCivil(date->year, date->month, date->day) * SECONDS_PER_DAY * unitsPerSecond;
+        }
+        case SQLDBC_HOSTTYPE_ODBCTIME: {
+            const SQL_TIME_STRUCT* time = (const SQL_TIME_STRUCT*) data;
+            return (time->hour * 3600 + time->minute * 60 + time->second) * unitsPerSecond;
+        }
+        default: {
+            // ODBC timestamp fraction is in nanoseconds
+            const SQL_TIMESTAMP_STRUCT* ts = (const SQL_TIMESTAMP_STRUCT*) data;
+
+            Tcl_WideInt seconds = daysFromCivil(ts->year, ts->month, ts->day) * SECONDS_PER_DAY + ts->hour * 3600 + ts->minute * 60 + ts->second;
+            return seconds * unitsPerSecond + ts->fraction / (1000000000 / unitsPerSecond);
+        }
+    }
+}
+
+SQLDBC_Length epochToDateTime (SQLDBC_HostType hostType, Tcl_WideInt epoch, Tcl_WideInt unitsPerSecond, void* data)
+{
+    Tcl_WideInt seconds = epoch / unitsPerSecond;
+    Tcl_WideInt units   = epoch % unitsPerSecond;
+    if (units < 0) {
+        units += unitsPerSecond;
+        seconds--;
+    }
+    Tcl_WideInt days = seconds / SECONDS_PER_DAY;
+    Tcl_WideInt secs = seconds % SECONDS_PER_DAY;
+    if (secs < 0) {
+        secs += SECONDS_PER_DAY;
+        days--;
+    }
+    // the year of the date structures is a 16-bit integer, and the database accepts years 1 to 9999
+    if (hostType != SQLDBC_HOSTTYPE_ODBCTIME && (days < daysFromCivil(1, 1, 1) || daysFromCivil(9999, 12, 31) < days)) {
+        return -1;
+    }
+    switch (hostType) {
+        case SQLDBC_HOSTTYPE_ODBCDATE: {
+            civilFromDays(days, (SQL_DATE_STRUCT*) data);
+            return sizeof(SQL_DATE_STRUCT);
+        }
+        case SQLDBC_HOSTTYPE_ODBCTIME: {
+            SQL_TIME_STRUCT* time = (SQL_TIME_STRUCT*) data;
+            time->hour   = secs / 3600;
+            time->minute = secs / 60 % 60;
+            time->second = secs % 60;
+            return sizeof(SQL_TIME_STRUCT);
+        }
+        default: {
+            SQL_TIMESTAMP_STRUCT* ts = (SQL_TIMESTAMP_STRUCT*) data;
+            SQL_DATE_STRUCT       date;
+            civilFromDays(days, &date);
+            ts->year     = date.year;
+            ts->month    = date.month;
+            ts->day      = date.day;
+            ts->hour     = secs / 3600;
+            ts->minute   = secs / 60 % 60;
+            ts->second   = secs % 60;
+            ts->fraction = units * (1000000000 / unitsPerSecond);
+            return sizeof(SQL_TIMESTAMP_STRUCT);
+        }
+    }
+}
+
+/**
+ * Returns true if the sign half-byte of the packed decimal marks negative number.
+ */
+static inline bool isNegativeDecimal (unsigned char signByte)
+{
+    unsigned char sign = signByte & 0x0F;
+    return sign == 0x0D || sign == 0x0B;
+}
+
+Tcl_Obj* newDecimalObj (const unsigned char* data, int digits)
+{
+    // digits are packed two per byte, the last half-byte is the sign
+    int  numDigits  = decimalSize(digits) * 2 - 1;
+    bool isNegative = isNegativeDecimal(data[numDigits / 2]);
+
+    if (digits <= 18) {
+        Tcl_WideInt value = 0;
+        for (int i = 0; i < numDigits; i++) {
+            value = value * 10 + (i % 2 == 0 ? data[i / 2] >> 4 : data[i / 2] & 0x0F);
+        }
+        return Tcl_NewWideIntObj(isNegative ? -value : value);
+    }
+
+    // Bignum is accumulated in chunks of 8 digits, that fit into the mp_digit, to reduce
+    // the number of the bignum operations
+    mp_int value;
+    if (mp_init(&value) != MP_OKAY) {
+        Tcl_Panic("cannot allocate bignum");
+    }
+    mp_digit chunk     = 0;
+    mp_digit chunkBase = 1;
+    for (int i = 0; i < numDigits; i++) {
+        chunk = chunk * 10 + (i % 2 == 0 ? data[i / 2] >> 4 : data[i / 2] & 0x0F);
+        chunkBase *= 10;
+        if (chunkBase == 100000000 || i == numDigits - 1) {
+            if (mp_mul_d(&value, chunkBase, &value) != MP_OKAY || mp_add_d(&value, chunk, &value) != MP_OKAY) {
+                Tcl_Panic("cannot allocate bignum");
+            }
+            chunk     = 0;
+            chunkBase = 1;
+        }
+    }
+    if (isNegative && !mp_iszero(&value)) {
+        value.sign = MP_NEG;
+    }
+    return Tcl_NewBignumObj(&value);
+}
+
+int formatDecimal (const unsigned char* data, int digits, char* text)
+{
+    int numDigits = decimalSize(digits) * 2 - 1;
+    int i         = 0;
+    while (i < numDigits - 1 && (i % 2 == 0 ? data[i / 2] >> 4 : data[i / 2] & 0x0F) == 0) {
+        ++i;
+    }
+    char* next = text;
+    // zero is never negative
+    if (isNegativeDecimal(data[numDigits / 2]) && (i < numDigits - 1 || (data[i / 2] >> 4) != 0)) {
+        *next++ = '-';
+    }
+    for (; i < numDigits; i++) {
+        *next++ = '0' + (i % 2 == 0 ? data[i / 2] >> 4 : data[i / 2] & 0x0F);
+    }
+    return next - text;
+}
+
+int packDecimal (Tcl_Interp* interp, Tcl_Obj* arg, int digits, unsigned char* data)
+{
+    int size      = decimalSize(digits);
+    int numDigits = size * 2 - 1;
+    std::memset(data, 0, size);
+
+    bool        isNegative;
+    bool        isTooLong;
+    int         i = numDigits - 1;
+    Tcl_WideInt wideValue;
+    if (Tcl_GetWideIntFromObj(nullptr, arg, &wideValue) == TCL_OK) {
+        isNegative = wideValue < 0;
+
+        Tcl_WideUInt value = isNegative ? -(Tcl_WideUInt) wideValue : wideValue;
+        for (; value != 0 && i >= 0; i--, value /= 10) {
+            data[i / 2] |= (i % 2 == 0 ? (value % 10) << 4 : value % 10);
+        }
+        isTooLong = value != 0;
+    } else {
+        mp_int value;
+        if (Tcl_GetBignumFromObj(interp, arg, &value) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        isNegative = value.sign == MP_NEG;
+        value.sign = MP_ZPOS;
+        for (; !mp_iszero(&value) && i >= 0; i--) {
+            mp_digit digit;
+            if (mp_div_d(&value, 10, &value, &digit) != MP_OKAY) {
+                mp_clear(&value);
+                TclSetResult(interp, "cannot convert integer into decimal", TCL_STATIC);
+                return TCL_ERROR;
+            }
+            data[i / 2] |= (i % 2 == 0 ? digit << 4 : digit);
+        }
+        isTooLong = !mp_iszero(&value);
+        mp_clear(&value);
+    }
+    // number of digits is limited by the precision rather than by the size of the packed decimal
+    if (isTooLong || numDigits - 1 - i > digits) {
+        Tcl_AppendResult(interp, "integer ", Tcl_GetString(arg), " has too many digits for a decimal parameter", nullptr);
+        return TCL_ERROR;
+    }
+    data[size - 1] |= (isNegative ? 0x0D : 0x0C);
+    return TCL_OK;
+}
+
+static void releaseTclObjs (Tcl_Obj** objPtr, Tcl_Obj** endPtr)
+{
+    for (; objPtr < endPtr; ++objPtr) {
+        if (*objPtr != nullptr) {
+            Tcl_DecrRefCount(*objPtr);
+            *objPtr = nullptr;
+        }
+    }
+}
+
+void releaseTclStrings ()
+{
+    releaseTclObjs(&tclStrings[0], &tclStrings[NUM_TCL_LIT_STRINGS]);
+    releaseTclObjs(&tclValues[0], &tclValues[NUM_TCL_VALUES]);
+    releaseTclObjs(&tclSqlTypeNames[0], &tclSqlTypeNames[NUM_SQL_TYPES]);
 }
 
 int findNamedValue (const char* namedValueType, const NamedValue* namedValue, Tcl_Interp* interp, Tcl_Obj* arg, int* value)
@@ -22,10 +22,28 @@ enum TclLit {
     bytelength,
     nullable,
     writable,
+    loaded,
+    rejected,
+    capacity,
+    size,
+    hits,
+    misses,
     UNKNOWN,
     NUM_TCL_LIT_STRINGS
 };
 
+#define TCL_VAL(v) getTclValue(v)
+
+/**
+ * Predefined immutable values that are shared by all fetched rows
+ */
+enum TclVal {
+    nullValue,
+    falseValue,
+    trueValue,
+    NUM_TCL_VALUES
+};
+
 /**
  * An item in an conversion table between textual and numeric
  * representation of values.
@@ -58,7 +76,80 @@ void setTclError (Tcl_Interp * interp, SQLDBC_ErrorHndl & error);
 Tcl_Obj * getTclString (TclLit lit, const char * value);
 
 /**
- * Unshares pooled shared TCL strings.
+ * Returns shared immutable TCL value. The pool holds a reference to the value, thus the value
+ * can be stored in lists and variables without the caller incrementing its reference counter.
+ */
+Tcl_Obj * getTclValue (TclVal val);
+
+/**
+ * Returns shared TCL string with the name of the SQL data type. Like values, type names are
+ * pinned by the pool.
+ */
+Tcl_Obj * getTclSqlTypeName (SQLDBC_SQLType sqlType);
+
+/**
+ * Converts fetched ODBC date, time or timestamp into the number of epoch units since 1970-01-01 00:00:00 UTC.
+ * Time values are converted into the number of units since midnight.
+ */
+Tcl_WideInt dateTimeToEpoch (SQLDBC_HostType hostType, const void * data, Tcl_WideInt unitsPerSecond);
+
+/**
+ * Converts the number of epoch units since 1970-01-01 00:00:00 UTC into ODBC date, time or timestamp.
+ * Returns the size of the converted value or -1 if the date is outside of years 1 to 9999.
+ */
+SQLDBC_Length epochToDateTime (SQLDBC_HostType hostType, Tcl_WideInt epoch, Tcl_WideInt unitsPerSecond, void * data);
+
+/**
+ * Maximum size of a packed decimal - FIXED(38).
+ */
+const int MAX_DECIMAL_SIZE = 20;
+
+/**
+ * Returns the size of a packed decimal with the given number of digits.
+ */
+static inline int decimalSize (int digits)
+{
+    return (digits + 2) / 2;
+}
+
+/**
+ * Returns true if the SQL type is one of the LONG (LOB) types.
+ */
+static inline bool isLongType (SQLDBC_SQLType sqlType)
+{
+    switch (sqlType) {
+        case SQLDBC_SQLTYPE_STRA:
+        case SQLDBC_SQLTYPE_STRB:
+        case SQLDBC_SQLTYPE_STRE:
+        case SQLDBC_SQLTYPE_STRUNI:
+        case SQLDBC_SQLTYPE_LONGA:
+        case SQLDBC_SQLTYPE_LONGB:
+        case SQLDBC_SQLTYPE_LONGE:
+        case SQLDBC_SQLTYPE_LONGUNI: return true;
+        default:                     return false;
+    }
+}
+
+/**
+ * Converts packed decimal into TCL integer. Decimals with up to 18 digits are converted
+ * into wide integers, longer ones - into bignums.
+ */
+Tcl_Obj * newDecimalObj (const unsigned char * data, int digits);
+
+/**
+ * Formats packed decimal as the text of an integer without leading zeros. The text buffer must
+ * have space for a sign and all the digits of the decimal. Returns the length of the text.
+ */
+int formatDecimal (const unsigned char * data, int digits, char * text);
+
+/**
+ * Converts TCL integer into packed decimal with the given number of digits.
+ * Returns TCL error if the argument is not an integer or it has too many digits.
+ */
+int packDecimal (Tcl_Interp * interp, Tcl_Obj * arg, int digits, unsigned char * data);
+
+/**
+ * Unshares pooled shared TCL strings and values.
  */
 void releaseTclStrings ();
 
@@ -155,6 +155,55 @@ describe "Database Connection" {
         assert "column value is 'a'" $row(DUMMY) eq "a"
     }
 
+    it "caches prepared statements" {
+        sdb connect cachedb {*}[array get ::opts] -chopblanks 1 -stmtcache 2
+        set sql "SELECT name FROM hotel.hotel WHERE zip = ?"
+        set numRows [cachedb execute $sql 60601]
+        assert "rows are returned" $numRows > 0
+        assert "first row is fetched" [cachedb fetch row] == 1
+        cachedb execute $sql 60601
+        set stats [cachedb get stmtcache]
+        cachedb disconnect
+        assert "cache capacity is 2" [dict get $stats capacity] == 2
+        assert "1 statement is cached" [dict get $stats size] == 1
+        assert "the second execution is a cache hit" [dict get $stats hits] == 1
+        assert "the first execution is a cache miss" [dict get $stats misses] == 1
+    }
+
+    it "lifts literals of ad-hoc SQL into parameters" {
+        sdb connect autodb {*}[array get ::opts] -chopblanks 1 -autoparam 1
+        set numRows [autodb execute "SELECT name FROM hotel.city WHERE zip = '60601'"]
+        assert "1 row returned" $numRows == 1
+        assert "row is fetched" [autodb fetch row] == 1
+        set numRows [autodb execute "SELECT name FROM hotel.city WHERE zip = '12203'"]
+        assert "1 row returned" $numRows == 1
+        set stats [autodb get stmtcache]
+        set numRows [autodb execute "SELECT 'x' || name FROM hotel.city WHERE zip IN ('60601', '12203') ORDER BY 1"]
+        assert "2 rows returned" $numRows == 2
+        autodb disconnect
+        assert "statement cache is enabled" [dict get $stats capacity] == 100
+        assert "SQL with different literals is prepared once" [dict get $stats size] == 1
+        assert "the second query reuses the statement" [dict get $stats hits] == 1
+        assert "the first query prepares the statement" [dict get $stats misses] == 1
+    }
+
+    it "remembers prepared statements in SQL literals" {
+        sdb connect litdb {*}[array get ::opts] -chopblanks 1 -stmtcache 1
+        proc findHotel { zip } {
+            litdb execute {SELECT name FROM hotel.hotel WHERE zip = ?} $zip
+        }
+        findHotel 60601
+        findHotel 60601
+        assert "SQL literal reuses its statement" [dict get [litdb get stmtcache] hits] == 1
+        litdb execute "SELECT name FROM hotel.city WHERE zip = ?" 60601
+        findHotel 60601
+        set stats [litdb get stmtcache]
+        litdb disconnect
+        rename findHotel {}
+        assert "SQL literal forgets the evicted statement" [dict get $stats hits] == 1
+        assert "evicted statement is prepared again" [dict get $stats misses] == 3
+    }
+
     it "disconnects from the database" {
         assert "database session is open" [count_sessions_from_this_process] == 1
         db disconnect
@@ -377,6 +426,229 @@ describe "Unprepared Statement" {
         expect "there is no row 4" { expr { !$fetched } }
     }
 
+    it "iterates over result set rows" {
+        set stmt [db newstatement]
+        set numRows [db execute $stmt "
+            SELECT h.name  AS hotel_name
+                 , r.type  AS room_type
+                 , r.free  AS num_available_rooms
+                 , r.price AS room_price
+             FROM hotel.room r
+             JOIN hotel.hotel h
+               ON h.hno = r.hno
+            WHERE h.zip = '60601'
+              AND r.price < 150
+            ORDER BY price
+        "]
+        assert "3 rows in the result set" $numRows == 3
+        set names {}
+        db foreach -asarray $stmt row nulls {
+            if {$row(ROOM_TYPE) eq "double"} {
+                continue
+            }
+            lappend names $row(HOTEL_NAME)
+            assert "hotel name is not null" $nulls(HOTEL_NAME) == 0
+        }
+        expect "single rooms are processed" {
+            expr { [llength $names] == 2 && [lindex $names 0] eq "Best View Parkview Inn" && [lindex $names 1] eq "Lake Michigan" }
+        }
+        db execute $stmt "SELECT * FROM hotel.room"
+        set count 0
+        db foreach $stmt row {
+            if {[incr count] == 2} {
+                break
+            }
+        }
+        assert "loop is stopped by break" $count == 2
+        set err [catch {
+            db foreach $stmt row {
+                error "body failed"
+            }
+        } res]
+        expect "body error is propagated" {
+            expr { $err == 1 && $res eq "body failed" }
+        }
+    }
+
+    it "fetches rows in row sets" {
+        set stmt [db newstatement]
+        set numRows [db execute $stmt "
+            SELECT h.name  AS hotel_name
+                 , r.type  AS room_type
+                 , r.free  AS num_available_rooms
+                 , r.price AS room_price
+             FROM hotel.room r
+             JOIN hotel.hotel h
+               ON h.hno = r.hno
+            WHERE h.zip = '60601'
+              AND r.price < 150
+            ORDER BY price
+        "]
+        assert "3 rows in the result set" $numRows == 3
+        expect "too large row set is rejected" {
+            expr { [catch {db fetch -rows 2000000000 $stmt rows} err] && $err eq "row set is too large, fetch fewer rows at once" }
+        }
+        set numFetched [db fetch -rows 2 $stmt rows nulls]
+        assert "2 rows are fetched" $numFetched == 2
+        assert "2 rows are returned" [llength $rows] == 2
+        assert "2 null indicator rows are returned" [llength $nulls] == 2
+        lassign [lindex $rows 0] hotel_name room_type num_available_rooms room_price
+        assert "hotel name is Best View Parkview Inn" $hotel_name eq "Best View Parkview Inn"
+        assert "room type is single" $room_type eq "single"
+        assert "number of free rooms is 87" $num_available_rooms == 87
+        assert "room price is 63" $room_price == 63
+        lassign [lindex $rows 1] hotel_name room_type num_available_rooms room_price
+        assert "hotel name is Lake Michigan" $hotel_name eq "Lake Michigan"
+        expect "all returned data are not null" {
+            expr { [lsearch [concat {*}$nulls] 1] < 0 }
+        }
+        set numFetched [db fetch -rows 2 $stmt rows]
+        assert "last row is fetched" $numFetched == 1
+        lassign [lindex $rows 0] hotel_name room_type num_available_rooms room_price
+        assert "hotel name is Best View Parkview Inn" $hotel_name eq "Best View Parkview Inn"
+        assert "room type is double" $room_type eq "double"
+        set numFetched [db fetch -rows 2 $stmt rows]
+        assert "there are no more rows" $numFetched == 0
+        assert "no rows are returned" [llength $rows] == 0
+    }
+
+    it "fetches result set columns" {
+        set stmt [db newstatement]
+        set numRows [db execute $stmt "
+            SELECT h.name  AS hotel_name
+                 , r.type  AS room_type
+                 , r.free  AS num_available_rooms
+                 , r.price AS room_price
+             FROM hotel.room r
+             JOIN hotel.hotel h
+               ON h.hno = r.hno
+            WHERE h.zip = '60601'
+              AND r.price < 150
+            ORDER BY price
+        "]
+        assert "3 rows in the result set" $numRows == 3
+        set numFetched [db fetch -columns -limit 2 $stmt cols nulls]
+        assert "2 rows are fetched" $numFetched == 2
+        assert "4 columns are returned" [dict size $cols] == 4
+        set names [dict get $cols HOTEL_NAME]
+        expect "hotel names of the first 2 rows" {
+            expr { [llength $names] == 2 && [lindex $names 0] eq "Best View Parkview Inn" && [lindex $names 1] eq "Lake Michigan" }
+        }
+        set prices [dict get $cols ROOM_PRICE]
+        expect "room prices of the first 2 rows" {
+            expr { [lindex $prices 0] == 63 && [lindex $prices 1] == 105 }
+        }
+        binary scan [dict get $nulls ROOM_PRICE] b2 priceIsNull
+        assert "room prices are not null" $priceIsNull eq "00"
+        set numFetched [db fetch -columns $stmt cols]
+        assert "last row is fetched" $numFetched == 1
+        assert "room type of the last row is double" [lindex [dict get $cols ROOM_TYPE] 0] eq "double"
+    }
+
+    it "rejects duplicate column labels in columnar fetch" {
+        set stmt [db newstatement]
+        db execute $stmt "SELECT h.name, c.name FROM hotel.hotel h JOIN hotel.city c ON c.zip = h.zip WHERE h.zip = '60601'"
+        expect "duplicate label is reported" {
+            expr { [catch {db fetch -columns $stmt cols} err] && $err eq "more than one column is labeled NAME, use column aliases to fetch them into a dict" }
+        }
+        assert "rows are not consumed" [db fetch $stmt row] == 1
+    }
+
+    it "interns values of the selected columns" {
+        set stmt [db newstatement]
+        set numRows [db execute -intern {ROOM_TYPE} $stmt "
+            SELECT r.type AS room_type
+                 , r.hno  AS hotel_no
+             FROM hotel.room r
+            WHERE r.type = 'single'
+        "]
+        assert "there are several single rooms" $numRows > 1
+        db fetch -columns -limit 2 $stmt cols
+        lassign [dict get $cols ROOM_TYPE] type1 type2
+        assert "room type is single" $type1 eq "single"
+        regexp {object pointer at (\S+),} [tcl::unsupported::representation $type1] -> objPtr1
+        regexp {object pointer at (\S+),} [tcl::unsupported::representation $type2] -> objPtr2
+        assert "room types reference the same object" $objPtr1 eq $objPtr2
+    }
+
+    it "converts fetched values lazily" {
+        set stmt [db newstatement]
+        set numRows [db execute -lazy 1 -decimal scaled $stmt "
+            SELECT h.name                   AS hotel_name
+                 , r.free                   AS num_available_rooms
+                 , FIXED(r.price, 20, 2)    AS room_price
+             FROM hotel.room r
+             JOIN hotel.hotel h
+               ON h.hno = r.hno
+            WHERE h.zip = '60601'
+              AND r.price < 150
+            ORDER BY price
+        "]
+        assert "3 rows in the result set" $numRows == 3
+        db fetch -rows 2 $stmt rows
+        db fetch -rows 2 $stmt more
+        lassign [lindex $rows 0] hotel_name num_available_rooms room_price
+        assert "free rooms are not formatted" [string match {*no string representation*} [tcl::unsupported::representation $num_available_rooms]] == 1
+        assert "room price is not converted yet" [string match {*sdbcell*} [tcl::unsupported::representation $room_price]] == 1
+        assert "hotel name is Best View Parkview Inn" $hotel_name eq "Best View Parkview Inn"
+        assert "number of free rooms is 87" $num_available_rooms == 87
+        assert "room price is formatted from its digits" $room_price eq "6300"
+        assert "room price is 63 scaled" $room_price == 6300
+        assert "one more row is fetched" [llength $more] == 1
+    }
+
+    it "converts dates to and from epoch values" {
+        set stmt [db prepare -datetime epoch "
+            SELECT arrival, departure
+              FROM hotel.reservation
+             WHERE arrival >= :ARRIVAL
+             ORDER BY arrival
+        "]
+        set minArrival [clock scan "2000-01-01" -format "%Y-%m-%d" -gmt 1]
+        set numRows [db execute $stmt :ARRIVAL $minArrival]
+        assert "there are reservations" $numRows > 0
+        db fetch $stmt row
+        lassign $row arrival departure
+        assert "arrival is an epoch integer" [string is wide -strict $arrival] == 1
+        assert "arrival is not earlier than requested" $arrival >= $minArrival
+        assert "arrival is at midnight" [expr {$arrival % 86400}] == 0
+        assert "departure is after arrival" $departure > $arrival
+        assert "digit strings are passed as dates" [db execute $stmt :ARRIVAL "20000101"] == $numRows
+
+        expect "out of range epoch is rejected" {
+            expr { [catch {db execute $stmt :ARRIVAL [expr {400000000000}]} err] && [string match "*outside of the supported date range" $err] }
+        }
+
+        set stmt [db prepare -datetime epochmicros "
+            SELECT arrival
+              FROM hotel.reservation
+             WHERE arrival >= :ARRIVAL
+             ORDER BY arrival
+        "]
+        db execute $stmt :ARRIVAL [expr {$minArrival * 1000000}]
+        db fetch $stmt row
+        assert "arrival is in microseconds" [lindex $row 0] == [expr {$arrival * 1000000}]
+    }
+
+    it "exchanges decimals as scaled integers" {
+        set stmt [db prepare -decimal scaled "
+            SELECT r.price AS room_price
+              FROM hotel.room r
+              JOIN hotel.hotel h
+                ON h.hno = r.hno
+             WHERE h.zip = '60601'
+               AND r.price < :MAX_PRICE
+             ORDER BY price
+        "]
+        set numRows [db execute $stmt :MAX_PRICE 15000]
+        set scale [dict get [db column $stmt 1] scale]
+        assert "3 rows in the result set" $numRows == 3
+        assert "price has 2 decimal digits" $scale == 2
+        db fetch $stmt row
+        assert "room price is an integer" [string is wide -strict [lindex $row 0]] == 1
+        assert "room price is scaled" [lindex $row 0] == 6300
+    }
+
     epilogue {
         if {[llength [info commands db]] == 1} {
             db disconnect
@@ -458,6 +730,164 @@ describe "Prepared Statement" {
         }
     }
 
+    it "reuses bound parameter values" {
+        set stmt [db prepare "SELECT name FROM city WHERE zip = ?"]
+        set zip 60601
+        assert "1 row returned" [db execute $stmt $zip] == 1
+        assert "row fetched" [db fetch $stmt row] == 1
+        set name [lindex $row 0]
+        assert "same argument returns the same row" [db execute $stmt $zip] == 1
+        assert "row fetched" [db fetch $stmt row] == 1
+        assert "the same city is found" [lindex $row 0] eq $name
+        assert "changed argument is copied" [db execute $stmt 00000] == 0
+    }
+
+    it "binds named parameters from a dict or an array" {
+        set stmt [db prepare "
+            SELECT count(*)
+              FROM room
+             WHERE hno = :HNO
+               AND price <= :MAX_PRICE
+        "]
+        set numRows [db execute $stmt -dict {HNO 20 MAX_PRICE 1000}]
+        assert "1 row returned" $numRows == 1
+        assert "row fetched" [db fetch $stmt row] == 1
+        lassign $row numRooms
+
+        array set args {HNO 20 MAX_PRICE 1000}
+        db execute $stmt -array args
+        assert "row fetched" [db fetch $stmt row] == 1
+        assert "the same rooms are counted" [lindex $row 0] == $numRooms
+
+        db execute $stmt -dict {hno 20 Max_Price 1000}
+        assert "row fetched" [db fetch $stmt row] == 1
+        assert "dict keys are matched regardless of case" [lindex $row 0] == $numRooms
+
+        array set mixed {hno 20 Max_Price 1000}
+        db execute $stmt -array mixed
+        assert "row fetched" [db fetch $stmt row] == 1
+        assert "array elements are matched regardless of case" [lindex $row 0] == $numRooms
+
+        expect "missing key is reported" {
+            expr { [catch {db execute $stmt -dict {HNO 20}} err] && $err eq "argument for parameter :MAX_PRICE is missing" }
+        }
+    }
+
+    it "binds repeated named parameters once" {
+        set stmt [db prepare "
+            SELECT type
+              FROM room
+             WHERE hno = :HNO
+               AND free >= :MIN_FREE
+               AND price <= (SELECT max(price) FROM room WHERE hno = :HNO)
+             ORDER BY type
+        "]
+        set numRows [db execute $stmt :hno 20 :MIN_FREE 0]
+        set numRowsAgain [db execute $stmt :hno 20 :MIN_FREE 0]
+        assert "same rows are returned" $numRowsAgain == $numRows
+        assert "rows are returned" $numRows > 0
+        expect "repeated parameter counts once" {
+            expr { [catch {db execute $stmt :HNO 20 :HNO 20 :MIN_FREE 0} err] && [string match "2 named arguments are expected*" $err] }
+        }
+    }
+
+    it "ignores parameter markers in literals and comments" {
+        set stmt [db prepare "
+            SELECT name || ' :NOT_A_PARAM?' AS name -- what about :THIS?
+              FROM city /* or :THAT? */
+             WHERE zip = :ZIP
+        "]
+        set numRows [db execute $stmt :ZIP 60601]
+        assert "1 row returned" $numRows == 1
+        assert "row fetched" [db fetch $stmt row] == 1
+        assert "marker in the literal is a text" [string match "* :NOT_A_PARAM?" [lindex $row 0]] == 1
+    }
+
+    it "executes statement for many argument rows" {
+        set stmt [db prepare "INSERT INTO city (zip, name, state) VALUES (:ZIP, :NAME, :STATE)"]
+        set rows {
+            {:ZIP 22580 :NAME Woodford :STATE VA}
+            {:STATE VA :NAME Ruther :ZIP 22546}
+            {:ZIP 22427 :NAME "Bowling Green" :STATE VA}
+        }
+        set res [db executemany -batch 2 $stmt $rows]
+        expect "status for each argument row" {
+            expr {
+                [llength $res] == 3 &&
+                [lindex $res 0] == 1 &&
+                [lindex $res 1] == 1 &&
+                [lindex $res 2] == 1
+            }
+        }
+        set numRows [db execute "SELECT name FROM city WHERE zip IN ('22580', '22546', '22427')"]
+        assert "all rows were inserted" $numRows == 3
+        db rollback
+    }
+
+    it "loads CSV records from a channel" {
+        set fileName [file tempfile chan]
+        puts $chan "22580,Woodford,VA"
+        puts $chan "22546,\"Ruther, Glen\",VA"
+        puts $chan "22427,Bowling Green"
+        puts $chan "22535,Port Royal,VA"
+        puts $chan "22501,Ladysmith,Virginia"
+        close $chan
+
+        set stmt [db prepare "INSERT INTO city (zip, name, state) VALUES (?, ?, ?)"]
+        set chan [open $fileName r]
+        set res [db load $stmt -channel $chan -format csv -batch 2]
+        close $chan
+        file delete $fileName
+
+        assert "3 records are loaded" [dict get $res loaded] == 3
+        assert "2 records are rejected" [dict get $res rejected] == 2
+        set numRows [db execute "SELECT name FROM city WHERE zip = '22501'"]
+        assert "too long field is rejected" $numRows == 0
+        set numRows [db execute "SELECT name FROM city WHERE zip = '22546'"]
+        assert "quoted field is loaded" [db fetch row] == 1
+        assert "name includes the delimiter" [lindex $row 0] eq "Ruther, Glen"
+
+        db execute "DELETE FROM city WHERE zip IN ('22580', '22546', '22535')"
+        db commit
+    }
+
+    it "loads records with a batch larger than the input" {
+        set fileName [file tempfile chan]
+        puts $chan "22580,Woodford,VA"
+        puts $chan "22535,Port Royal,VA"
+        close $chan
+
+        set stmt [db prepare "INSERT INTO city (zip, name, state) VALUES (?, ?, ?)"]
+        set chan [open $fileName r]
+        set res [db load $stmt -channel $chan -batch 2000000000]
+        close $chan
+        file delete $fileName
+
+        assert "2 records are loaded" [dict get $res loaded] == 2
+        assert "no records are rejected" [dict get $res rejected] == 0
+
+        db execute "DELETE FROM city WHERE zip IN ('22580', '22535')"
+        db commit
+    }
+
+    it "reports unterminated quoted field" {
+        set fileName [file tempfile chan]
+        puts $chan "22580,Woodford,VA"
+        puts -nonewline $chan "22546,\"Ruther, Glen,VA"
+        close $chan
+
+        set stmt [db prepare "INSERT INTO city (zip, name, state) VALUES (?, ?, ?)"]
+        set chan [open $fileName r]
+        set failed [catch {db load $stmt -channel $chan -format csv} err]
+        close $chan
+        file delete $fileName
+
+        assert "load fails" $failed == 1
+        assert "malformed input is reported" $err eq "malformed input: quoted field is not terminated at the end of the input"
+        set numRows [db execute "SELECT name FROM city WHERE zip = '22580'"]
+        assert "records of the failed batch are not loaded" $numRows == 0
+    }
+
     it "accepts OUT variables" {
         set numRows [db execute "
             SELECT Count(*)
@@ -552,6 +982,7 @@ describe "LOB" {
         set numRows [db exec $stmt $clobText $blobData]
         assert "row inserted" $numRows == 1
         set id [db serial $stmt]
+        assert "single insert generated one key" [db serial -all $stmt] eq $id
 
         set query [db prepare "SELECT txt, bin FROM media WHERE id = ?"]
         assert "one row in the result" [db exec $query $id] == 1
@@ -582,6 +1013,82 @@ describe "LOB" {
         db rollback
     }
 
+    it "streams parameter values from LOB sources" {
+        set numRows [db exec "SELECT Count(*) FROM tables WHERE schemaname = 'HOTEL' and tablename = 'MEDIA'"]
+        if { $numRows == 0 || ![db fetch row] || [lindex $row 0] == 0} {
+            db exec "CREATE TABLE media (id SERIAL PRIMARY KEY, txt CLOB UNICODE, bin BLOB)"
+            db commit
+        }
+        set blobData [string repeat "<<< streamed blob >>>\r\n" 10000]
+        set clobText [string repeat "*** streamed clob ***\n" 10000]
+        set blobPath [file tempfile chan]
+        chan configure $chan -translation binary
+        puts -nonewline $chan $blobData
+        close $chan
+        set clobPath [file tempfile chan]
+        chan configure $chan -encoding utf-8
+        puts -nonewline $chan $clobText
+        close $chan
+
+        set stmt [db prepare "INSERT INTO media (txt, bin) VALUES (:TXT, :BIN)"]
+        set chan [open $clobPath r]
+        chan configure $chan -encoding utf-8
+        set numRows [db exec $stmt :TXT [db lobsource -channel $chan] :BIN [db lobsource -file $blobPath]]
+        close $chan
+        assert "row inserted" $numRows == 1
+        set id [db serial $stmt]
+
+        # the channel of the BLOB is read without translation of the line ends
+        set chan [open $blobPath r]
+        chan configure $chan -translation crlf -encoding iso8859-1
+        set numRows [db exec $stmt :TXT [db lobsource -file $clobPath] :BIN [db lobsource -channel $chan]]
+        assert "channel translation is restored" [chan configure $chan -translation] eq "crlf"
+        assert "channel encoding is restored" [chan configure $chan -encoding] eq "iso8859-1"
+        close $chan
+        file delete $blobPath $clobPath
+        assert "row inserted" $numRows == 1
+        set chanId [db serial $stmt]
+
+        set query [db prepare "SELECT txt, bin FROM media WHERE id = ?"]
+        assert "one row in the result" [db exec $query $chanId] == 1
+        assert "row fetched" [db fetch $query row] == 1
+        lassign $row clob blob
+        set text [db read $clob [string length $clobText]]
+        set data [db read $blob [string length $blobData]]
+        db close $clob
+        db close $blob
+        assert "text from the file is inserted" $text eq $clobText
+        assert "data from the channel are inserted" $data eq $blobData
+
+        assert "one row in the result" [db exec $query $id] == 1
+        assert "row fetched" [db fetch $query row] == 1
+        lassign $row clob blob
+        set text [db read $clob [string length $clobText]]
+        set data [db read $blob [string length $blobData]]
+        db close $clob
+        db close $blob
+        assert "text from the channel is inserted" $text eq $clobText
+        assert "data from the file are inserted" $data eq $blobData
+
+        db rollback
+    }
+
+    it "returns serial keys of every batch" {
+        set numRows [db exec "SELECT Count(*) FROM tables WHERE schemaname = 'HOTEL' and tablename = 'MEDIA'"]
+        if { $numRows == 0 || ![db fetch row] || [lindex $row 0] == 0} {
+            db exec "CREATE TABLE media (id SERIAL PRIMARY KEY, txt CLOB UNICODE, bin BLOB)"
+            db commit
+        }
+        set stmt [db prepare "INSERT INTO media (txt) VALUES (?)"]
+        set res [db executemany -batch 2 $stmt {{one} {two} {three}}]
+        assert "3 rows inserted" [llength $res] == 3
+        set keys [db serial -all $stmt]
+        assert "one key per inserted row" [llength $keys] == 3
+        assert "keys are distinct" [llength [lsort -unique $keys]] == 3
+        assert "last key is the last of all keys" [db serial $stmt] == [lindex $keys end]
+        db rollback
+    }
+
     it "reads LOB column content" {
         set stmt [db prepare "SELECT info FROM hotel WHERE hno = :HNO"]
         set hno 10
@@ -603,6 +1110,69 @@ describe "LOB" {
         db close $lob
     }
 
+    it "reads LOB content into a variable" {
+        set stmt [db prepare "SELECT info FROM hotel WHERE hno = ?"]
+        assert "one row in the result" [db execute $stmt 10] == 1
+        assert "row is fetched" [db fetch $stmt row] == 1
+        lassign $row lob
+        set text [db read -from 1 $lob [db length $lob]]
+        set reread ""
+        set numRead [db read -from 1 -into chunk $lob 256]
+        while {$numRead > 0} {
+            append reread $chunk
+            set numRead [db read -into chunk $lob 256]
+        }
+        assert "CLOB is read into the variable" $reread eq $text
+        db close $lob
+    }
+
+    it "reads LOB content ahead" {
+        set stmt [db prepare "SELECT info FROM hotel WHERE hno = ?"]
+        assert "one row in the result" [db execute $stmt 10] == 1
+        assert "row is fetched" [db fetch $stmt row] == 1
+        lassign $row lob
+        set text [db read -from 1 $lob [db length $lob]]
+        assert "read-ahead is enabled" [db readahead $lob 2] == 2
+        set prefetched [db read -from 1 $lob 256]
+        while {[db read -into chunk $lob 256] > 0} {
+            append prefetched $chunk
+        }
+        assert "CLOB is read ahead" $prefetched eq $text
+        assert "read-ahead is disabled" [db readahead $lob 0] == 0
+        db close $lob
+    }
+
+    it "streams LOB content through a channel" {
+        set stmt [db prepare "SELECT info FROM hotel WHERE hno = ?"]
+        assert "one row in the result" [db execute $stmt 10] == 1
+        assert "row is fetched" [db fetch $stmt row] == 1
+        lassign $row lob
+        set lobLen [db length $lob]
+        set chan [db open $lob]
+        set text [read $chan]
+        close $chan
+        assert "CLOB is read from the channel" [string length $text] == $lobLen
+        db close $lob
+    }
+
+    it "fetches short LOBs as values" {
+        set stmt [db prepare "SELECT info FROM hotel WHERE hno = ?"]
+        assert "one row in the result" [db execute $stmt 10] == 1
+        assert "row is fetched" [db fetch $stmt row] == 1
+        lassign $row lob
+        set lobLen [db length $lob]
+        set text [db read -from 1 $lob $lobLen]
+        db close $lob
+        assert "one row in the result" [db execute -lobinline [expr {$lobLen + 1}] $stmt 10] == 1
+        assert "row is fetched" [db fetch $stmt row] == 1
+        assert "CLOB is fetched as its text" [lindex $row 0] eq $text
+        assert "one row in the result" [db execute -lobinline $lobLen $stmt 10] == 1
+        assert "row is fetched" [db fetch $stmt row] == 1
+        lassign $row lob
+        assert "longer CLOB is fetched as a handle" [db length $lob] == $lobLen
+        db close $lob
+    }
+
     epilogue {
         if {[llength [info commands db]] == 1} {
             db disconnect